@@ -1,6 +1,7 @@
 #include "handlers.h"
 #include "../core/lr0_parser.h"
 #include "../core/slr1_parser.h"
+#include "../core/ll1_parser.h"
 #include "../core/regex_automata.h"
 #include <fstream>
 #include <sstream>
@@ -43,6 +44,21 @@ namespace APIHandlers {
         }
     }
     
+    // 读取可选的 construction 字段（thompson/glushkov/derivative，默认 thompson），取值无效时返回 false
+    bool parseConstruction(const crow::json::rvalue& body, RegexAutomata::Construction& construction) {
+        std::string name = body.has("construction") ? std::string(body["construction"].s()) : "thompson";
+        if (name == "glushkov") {
+            construction = RegexAutomata::Construction::Glushkov;
+        } else if (name == "derivative") {
+            construction = RegexAutomata::Construction::Derivative;
+        } else if (name == "thompson") {
+            construction = RegexAutomata::Construction::Thompson;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    
     // 健康检查端点
     crow::response handleHealthCheck(const crow::request& req) {
         try {
@@ -237,11 +253,21 @@ namespace APIHandlers {
                 return crow::response(400, error);
             }
             
+            // 可选：跳过单产生式归约链
+            SLR1Parser::ParseOptions options;
+            if (jsonBody.has("eliminateUnitReductions")) {
+                options.eliminateUnitReductions = jsonBody["eliminateUnitReductions"].b();
+            }
+            // 可选：选择入口开始符号（文法中用 %start 声明）
+            if (jsonBody.has("startSymbol")) {
+                options.startSymbol = jsonBody["startSymbol"].s();
+            }
+            
             // 读取语法
             SLR1Parser::readGrammarFromString(grammar);
             
             // 执行SLR1解析
-            auto result = SLR1Parser::parseInput(input);
+            auto result = SLR1Parser::parseInput(input, options);
             
             // 构建响应
             crow::json::wvalue response;
@@ -259,9 +285,21 @@ namespace APIHandlers {
                 stepJson["symbolStack"] = step.symbolStack;
                 stepJson["remainingInput"] = step.remainingInput;
                 stepJson["action"] = step.action;
+                
+                crow::json::wvalue bypassed(crow::json::type::List);
+                for (size_t j = 0; j < step.bypassedProductions.size(); ++j) {
+                    bypassed[j] = step.bypassedProductions[j];
+                }
+                stepJson["bypassedProductions"] = std::move(bypassed);
+                stepJson["valueStack"] = step.valueStack;
                 parseSteps[i] = std::move(stepJson);
             }
             response["parseSteps"] = std::move(parseSteps);
+            response["bypassedReductionCount"] = result.bypassedReductionCount;
+            
+            // 语义动作计算结果
+            response["hasSemanticValue"] = result.hasSemanticValue;
+            response["semanticValue"] = result.semanticValue;
             
             // 分析表
             crow::json::wvalue parseTable;
@@ -332,6 +370,7 @@ namespace APIHandlers {
                     rightSide[j] = prod.rightSide[j];
                 }
                 prodJson["rightSide"] = std::move(rightSide);
+                prodJson["semanticAction"] = prod.semanticAction;
                 
                 productionList[i] = std::move(prodJson);
             }
@@ -361,6 +400,13 @@ namespace APIHandlers {
             }
             response["followSets"] = std::move(followSets);
             
+            // 开始符号
+            crow::json::wvalue startSymbols(crow::json::type::List);
+            for (size_t i = 0; i < result.startSymbols.size(); ++i) {
+                startSymbols[i] = result.startSymbols[i];
+            }
+            response["startSymbols"] = std::move(startSymbols);
+            
             auto endTime = std::chrono::steady_clock::now();
             auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
             
@@ -380,6 +426,192 @@ namespace APIHandlers {
         }
     }
     
+    // LL1预测分析端点
+    crow::response handleLL1Parse(const crow::request& req) {
+        auto startTime = std::chrono::steady_clock::now();
+        
+        try {
+            auto jsonBody = crow::json::load(req.body);
+            if (!jsonBody) {
+                crow::json::wvalue error;
+                error["error"] = "Invalid JSON format";
+                return crow::response(400, error);
+            }
+            
+            // 获取请求参数
+            std::string grammar = jsonBody["grammar"].s();
+            std::string input = jsonBody["input"].s();
+            
+            if (grammar.empty()) {
+                crow::json::wvalue error;
+                error["error"] = "Grammar is required";
+                return crow::response(400, error);
+            }
+            
+            if (input.empty()) {
+                crow::json::wvalue error;
+                error["error"] = "Input string is required";
+                return crow::response(400, error);
+            }
+            
+            // 可选：指定开始符号（默认为文法的开始符号）
+            std::string startSymbol;
+            if (jsonBody.has("startSymbol")) {
+                startSymbol = jsonBody["startSymbol"].s();
+            }
+            
+            // 读取语法并构建预测分析表
+            LL1Parser::readGrammarFromString(grammar);
+            
+            // 执行LL1解析
+            auto result = LL1Parser::parseInput(input, startSymbol);
+            
+            // 构建响应
+            crow::json::wvalue response;
+            response["success"] = result.success;
+            response["message"] = result.message;
+            response["isAccepted"] = result.isAccepted;
+            response["isLL1"] = result.isLL1;
+            
+            // 解析步骤
+            crow::json::wvalue parseSteps(crow::json::type::List);
+            for (size_t i = 0; i < result.parseSteps.size(); ++i) {
+                const auto& step = result.parseSteps[i];
+                crow::json::wvalue stepJson;
+                stepJson["step"] = step.step;
+                stepJson["stateStack"] = step.stateStack;
+                stepJson["symbolStack"] = step.symbolStack;
+                stepJson["remainingInput"] = step.remainingInput;
+                stepJson["action"] = step.action;
+                parseSteps[i] = std::move(stepJson);
+            }
+            response["parseSteps"] = std::move(parseSteps);
+            
+            // 预测分析表
+            crow::json::wvalue parseTable;
+            crow::json::wvalue headers(crow::json::type::List);
+            for (size_t i = 0; i < result.parseTable.headers.size(); ++i) {
+                headers[i] = result.parseTable.headers[i];
+            }
+            parseTable["headers"] = std::move(headers);
+            
+            crow::json::wvalue rows(crow::json::type::List);
+            for (size_t i = 0; i < result.parseTable.rows.size(); ++i) {
+                const auto& row = result.parseTable.rows[i];
+                crow::json::wvalue rowJson;
+                rowJson["nonterminal"] = row.nonterminal;
+                
+                crow::json::wvalue actions;
+                for (const auto& action : row.actions) {
+                    actions[action.first] = action.second;
+                }
+                rowJson["actions"] = std::move(actions);
+                
+                rows[i] = std::move(rowJson);
+            }
+            parseTable["rows"] = std::move(rows);
+            response["parseTable"] = std::move(parseTable);
+            
+            // 冲突表项
+            crow::json::wvalue conflicts(crow::json::type::List);
+            for (size_t i = 0; i < result.conflicts.size(); ++i) {
+                const auto& conflict = result.conflicts[i];
+                crow::json::wvalue conflictJson;
+                conflictJson["nonterminal"] = conflict.nonterminal;
+                conflictJson["terminal"] = conflict.terminal;
+                
+                crow::json::wvalue conflictProductions(crow::json::type::List);
+                for (size_t j = 0; j < conflict.productions.size(); ++j) {
+                    conflictProductions[j] = conflict.productions[j];
+                }
+                conflictJson["productions"] = std::move(conflictProductions);
+                conflicts[i] = std::move(conflictJson);
+            }
+            response["conflicts"] = std::move(conflicts);
+
+            // 左递归的非终结符
+            crow::json::wvalue leftRecursive(crow::json::type::List);
+            for (size_t i = 0; i < result.leftRecursiveNonterminals.size(); ++i) {
+                leftRecursive[i] = result.leftRecursiveNonterminals[i];
+            }
+            response["leftRecursiveNonterminals"] = std::move(leftRecursive);
+            
+            // 产生式
+            crow::json::wvalue productions;
+            for (const auto& prod : result.productions) {
+                crow::json::wvalue rightSides(crow::json::type::List);
+                for (size_t i = 0; i < prod.second.size(); ++i) {
+                    crow::json::wvalue rightSide(crow::json::type::List);
+                    for (size_t j = 0; j < prod.second[i].size(); ++j) {
+                        rightSide[j] = prod.second[i][j];
+                    }
+                    rightSides[i] = std::move(rightSide);
+                }
+                productions[prod.first] = std::move(rightSides);
+            }
+            response["productions"] = std::move(productions);
+
+            // 按序号排列的产生式列表
+            crow::json::wvalue productionList(crow::json::type::List);
+            for (size_t i = 0; i < result.productionList.size(); ++i) {
+                const auto& prod = result.productionList[i];
+                crow::json::wvalue prodJson;
+                prodJson["index"] = prod.index;
+                prodJson["leftSide"] = prod.leftSide;
+                
+                crow::json::wvalue rightSide(crow::json::type::List);
+                for (size_t j = 0; j < prod.rightSide.size(); ++j) {
+                    rightSide[j] = prod.rightSide[j];
+                }
+                prodJson["rightSide"] = std::move(rightSide);
+                
+                productionList[i] = std::move(prodJson);
+            }
+            response["productionList"] = std::move(productionList);
+            
+            // FIRST集合
+            crow::json::wvalue firstSets;
+            for (const auto& firstSet : result.firstSets) {
+                crow::json::wvalue symbols(crow::json::type::List);
+                size_t i = 0;
+                for (const auto& symbol : firstSet.second) {
+                    symbols[i++] = symbol;
+                }
+                firstSets[firstSet.first] = std::move(symbols);
+            }
+            response["firstSets"] = std::move(firstSets);
+            
+            // FOLLOW集合
+            crow::json::wvalue followSets;
+            for (const auto& followSet : result.followSets) {
+                crow::json::wvalue symbols(crow::json::type::List);
+                size_t i = 0;
+                for (const auto& symbol : followSet.second) {
+                    symbols[i++] = symbol;
+                }
+                followSets[followSet.first] = std::move(symbols);
+            }
+            response["followSets"] = std::move(followSets);
+            
+            auto endTime = std::chrono::steady_clock::now();
+            auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            
+            std::cout << "[INFO] LL1 parse request processed in " << totalDuration.count() << "ms" << std::endl;
+            
+            crow::response res(200, response);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Content-Type", "application/json");
+            return res;
+            
+        } catch (const std::exception& e) {
+            crow::json::wvalue error;
+            error["error"] = "Internal server error: " + std::string(e.what());
+            crow::response res(500, error);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            return res;
+        }
+    }
+    
     // 正则表达式自动机构建端点
     crow::response handleRegexBuild(const crow::request& req) {
         auto startTime = std::chrono::steady_clock::now();
@@ -397,6 +629,16 @@ namespace APIHandlers {
             
             std::string regex = jsonBody["regex"].s();
             
+            // 可选：自动机构造方式（thompson/glushkov/derivative）
+            RegexAutomata::Construction construction = RegexAutomata::Construction::Thompson;
+            if (!parseConstruction(jsonBody, construction)) {
+                crow::json::wvalue error;
+                error["error"] = "Unknown construction (expected thompson, glushkov or derivative)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
             if (regex.empty()) {
                 crow::json::wvalue error;
                 error["error"] = "Regex is required";
@@ -418,7 +660,7 @@ namespace APIHandlers {
             
             // 在一个简单的超时检查中执行构建
             auto buildStart = std::chrono::steady_clock::now();
-            result.success = RegexAutomata::buildFromRegex(regex);
+            result.success = RegexAutomata::buildFromRegex(regex, construction);
             auto buildEnd = std::chrono::steady_clock::now();
             
             auto buildDuration = std::chrono::duration_cast<std::chrono::seconds>(buildEnd - buildStart);
@@ -434,6 +676,7 @@ namespace APIHandlers {
                 result.message = "Automata built successfully";
                 result.nfaDescription = RegexAutomata::getNFADescription();
                 result.dfaDescription = RegexAutomata::getDFADescription();
+                result.lazyDfa = RegexAutomata::usesLazyDFA();
                 
                 // 生成SVG图像
                 std::string nfaDot = RegexAutomata::generateNFADot();
@@ -444,7 +687,7 @@ namespace APIHandlers {
                 result.dfaSvg = generateSVGFromDot(dfaDot);
                 result.minimizedDfaSvg = generateSVGFromDot(minimizedDfaDot);
             } else {
-                result.message = "Failed to build automata";
+                result.message = "Failed to build automata: " + RegexAutomata::getLastError();
             }
             
             auto endTime = std::chrono::steady_clock::now();
@@ -484,6 +727,33 @@ namespace APIHandlers {
             std::string regex = jsonBody["regex"].s();
             std::string input = jsonBody["input"].s();
             
+            // 可选：匹配引擎（auto/dfa/pikevm/bitparallel）；visualize 为 false 时不生成描述和图像，auto 模式下不构建DFA
+            std::string engineName = jsonBody.has("engine") ? std::string(jsonBody["engine"].s()) : "auto";
+            bool visualize = jsonBody.has("visualize") ? jsonBody["visualize"].b() : true;
+            RegexAutomata::MatchEngine engine = RegexAutomata::MatchEngine::Auto;
+            if (engineName == "dfa") {
+                engine = RegexAutomata::MatchEngine::DFA;
+            } else if (engineName == "pikevm") {
+                engine = RegexAutomata::MatchEngine::PikeVM;
+            } else if (engineName == "bitparallel") {
+                engine = RegexAutomata::MatchEngine::BitParallel;
+            } else if (engineName != "auto") {
+                crow::json::wvalue error;
+                error["error"] = "Unknown engine (expected auto, dfa, pikevm or bitparallel)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            RegexAutomata::Construction construction = RegexAutomata::Construction::Thompson;
+            if (!parseConstruction(jsonBody, construction)) {
+                crow::json::wvalue error;
+                error["error"] = "Unknown construction (expected thompson, glushkov or derivative)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
             if (regex.empty() || input.empty()) {
                 crow::json::wvalue error;
                 error["error"] = "Both regex and input are required";
@@ -505,7 +775,7 @@ namespace APIHandlers {
             
             // 首先构建自动机（带超时检查）
             auto buildStart = std::chrono::steady_clock::now();
-            if (RegexAutomata::buildFromRegex(regex)) {
+            if (RegexAutomata::buildFromRegex(regex, construction)) {
                 auto buildEnd = std::chrono::steady_clock::now();
                 auto buildDuration = std::chrono::duration_cast<std::chrono::seconds>(buildEnd - buildStart);
                 
@@ -521,7 +791,11 @@ namespace APIHandlers {
                 
                 // 执行匹配（带超时检查）
                 auto matchStart = std::chrono::steady_clock::now();
-                result.matchResult = RegexAutomata::matchString(input);
+                result.matchResult = RegexAutomata::matchString(input, engine);
+                result.engine = RegexAutomata::getLastMatchEngine();
+                if (result.matchResult && (result.engine == "pikevm" || result.engine == "bitparallel")) {
+                    RegexAutomata::matchWithCaptures(input, result.captures);
+                }
                 auto matchEnd = std::chrono::steady_clock::now();
                 
                 auto matchDuration = std::chrono::duration_cast<std::chrono::seconds>(matchEnd - matchStart);
@@ -534,20 +808,23 @@ namespace APIHandlers {
                 }
                 
                 result.message = result.matchResult ? "String matches regex" : "String does not match regex";
-                result.nfaDescription = RegexAutomata::getNFADescription();
-                result.dfaDescription = RegexAutomata::getDFADescription();
-                
-                // 生成SVG图像
-                std::string nfaDot = RegexAutomata::generateNFADot();
-                std::string dfaDot = RegexAutomata::generateDFADot();
-                std::string minimizedDfaDot = RegexAutomata::generateMinimizedDFADot();
-                
-                result.nfaSvg = generateSVGFromDot(nfaDot);
-                result.dfaSvg = generateSVGFromDot(dfaDot);
-                result.minimizedDfaSvg = generateSVGFromDot(minimizedDfaDot);
+                if (visualize) {
+                    result.nfaDescription = RegexAutomata::getNFADescription();
+                    result.dfaDescription = RegexAutomata::getDFADescription();
+                    
+                    // 生成SVG图像
+                    std::string nfaDot = RegexAutomata::generateNFADot();
+                    std::string dfaDot = RegexAutomata::generateDFADot();
+                    std::string minimizedDfaDot = RegexAutomata::generateMinimizedDFADot();
+                    
+                    result.nfaSvg = generateSVGFromDot(nfaDot);
+                    result.dfaSvg = generateSVGFromDot(dfaDot);
+                    result.minimizedDfaSvg = generateSVGFromDot(minimizedDfaDot);
+                    result.lazyDfa = RegexAutomata::usesLazyDFA();
+                }
             } else {
                 result.success = false;
-                result.message = "Failed to build automata from regex";
+                result.message = "Failed to build automata from regex: " + RegexAutomata::getLastError();
                 result.matchResult = false;
             }
             
@@ -570,6 +847,362 @@ namespace APIHandlers {
         }
     }
     
+    // 正则表达式集合端点：所有模式编译为一个乘积DFA，一次扫描报告所有匹配的模式
+    crow::response handleRegexSet(const crow::request& req) {
+        auto startTime = std::chrono::steady_clock::now();
+        const size_t MAX_PATTERNS = 1000;
+        
+        try {
+            auto jsonBody = crow::json::load(req.body);
+            if (!jsonBody) {
+                crow::json::wvalue error;
+                error["error"] = "Invalid JSON format";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            if (!jsonBody.has("patterns") || jsonBody["patterns"].size() == 0) {
+                crow::json::wvalue error;
+                error["error"] = "Patterns are required";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            std::vector<std::string> patterns;
+            for (size_t i = 0; i < jsonBody["patterns"].size(); ++i) {
+                patterns.push_back(jsonBody["patterns"][i].s());
+            }
+            std::string input = jsonBody.has("input") ? std::string(jsonBody["input"].s()) : "";
+            
+            bool patternTooLong = false;
+            for (const auto& pattern : patterns) {
+                if (pattern.empty() || pattern.length() > 1000) patternTooLong = true;
+            }
+            if (patterns.size() > MAX_PATTERNS || patternTooLong || input.length() > 10000) {
+                crow::json::wvalue error;
+                error["error"] = "Input too long (max 1000 non-empty patterns of 1000 chars, input max 10000 chars)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            crow::json::wvalue response;
+            try {
+                RegexAutomata::RegexSet set(patterns);
+                std::vector<int> matched = set.matches(input);
+                
+                response["success"] = true;
+                response["message"] = std::to_string(matched.size()) + " of " + std::to_string(patterns.size()) + " patterns match";
+                response["patternCount"] = patterns.size();
+                response["matchedPatterns"] = crow::json::wvalue::list();
+                response["matches"] = crow::json::wvalue::list();
+                for (size_t i = 0; i < matched.size(); ++i) {
+                    response["matchedPatterns"][i] = matched[i];
+                    response["matches"][i]["index"] = matched[i];
+                    response["matches"][i]["pattern"] = patterns[matched[i]];
+                }
+                response["nfaStates"] = set.nfaStates();
+                response["dfaStates"] = set.cachedStates();
+            } catch (const std::runtime_error& e) {
+                response["success"] = false;
+                response["message"] = e.what();
+                response["matchedPatterns"] = crow::json::wvalue::list();
+                response["matches"] = crow::json::wvalue::list();
+            }
+            
+            auto endTime = std::chrono::steady_clock::now();
+            auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            
+            std::cout << "[INFO] Regex set request processed in " << totalDuration.count() << "ms" << std::endl;
+            
+            crow::response res(200, response);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Content-Type", "application/json");
+            return res;
+            
+        } catch (const std::exception& e) {
+            crow::json::wvalue error;
+            error["error"] = "Internal server error: " + std::string(e.what());
+            crow::response res(500, error);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            return res;
+        }
+    }
+    
+    // 正则表达式批量匹配端点：同一正则表达式对多个输入逐个整串匹配，返回结果位图
+    crow::response handleRegexMatchBatch(const crow::request& req) {
+        auto startTime = std::chrono::steady_clock::now();
+        const size_t MAX_BATCH_INPUTS = 100000;
+        const size_t MAX_BATCH_BYTES = 10000000;
+        
+        try {
+            auto jsonBody = crow::json::load(req.body);
+            if (!jsonBody) {
+                crow::json::wvalue error;
+                error["error"] = "Invalid JSON format";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            std::string regex = jsonBody.has("regex") ? std::string(jsonBody["regex"].s()) : "";
+            if (regex.empty() || !jsonBody.has("inputs")) {
+                crow::json::wvalue error;
+                error["error"] = "Both regex and inputs are required";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            RegexAutomata::Construction construction = RegexAutomata::Construction::Thompson;
+            if (!parseConstruction(jsonBody, construction)) {
+                crow::json::wvalue error;
+                error["error"] = "Unknown construction (expected thompson, glushkov or derivative)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            std::vector<std::string> inputs;
+            size_t totalBytes = 0;
+            for (size_t i = 0; i < jsonBody["inputs"].size(); ++i) {
+                inputs.push_back(jsonBody["inputs"][i].s());
+                totalBytes += inputs.back().size();
+            }
+            if (regex.length() > 1000 || inputs.size() > MAX_BATCH_INPUTS || totalBytes > MAX_BATCH_BYTES) {
+                crow::json::wvalue error;
+                error["error"] = "Input too long (regex max 1000 chars, max 100000 inputs totalling 10000000 chars)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            crow::json::wvalue response;
+            if (RegexAutomata::buildFromRegex(regex, construction)) {
+                auto matchStart = std::chrono::steady_clock::now();
+                std::vector<uint64_t> verdicts = RegexAutomata::matchBatch(inputs);
+                auto matchEnd = std::chrono::steady_clock::now();
+                
+                // 位图按输入顺序展开成 '0'/'1' 字符串
+                std::string bitmap(inputs.size(), '0');
+                size_t matchCount = 0;
+                for (size_t i = 0; i < inputs.size(); ++i) {
+                    if ((verdicts[i / 64] >> (i % 64)) & 1) {
+                        bitmap[i] = '1';
+                        matchCount++;
+                    }
+                }
+                
+                response["success"] = true;
+                response["message"] = std::to_string(matchCount) + " of " + std::to_string(inputs.size()) + " inputs match";
+                response["inputCount"] = inputs.size();
+                response["matchCount"] = matchCount;
+                response["verdicts"] = bitmap;
+                response["engine"] = RegexAutomata::getLastMatchEngine();
+                response["matchTimeMs"] = std::chrono::duration<double, std::milli>(matchEnd - matchStart).count();
+            } else {
+                response["success"] = false;
+                response["message"] = "Failed to build automata from regex: " + RegexAutomata::getLastError();
+                response["inputCount"] = inputs.size();
+                response["matchCount"] = 0;
+                response["verdicts"] = "";
+            }
+            
+            auto endTime = std::chrono::steady_clock::now();
+            auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            
+            std::cout << "[INFO] Regex batch match request processed in " << totalDuration.count() << "ms" << std::endl;
+            
+            crow::response res(200, response);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Content-Type", "application/json");
+            return res;
+            
+        } catch (const std::exception& e) {
+            crow::json::wvalue error;
+            error["error"] = "Internal server error: " + std::string(e.what());
+            crow::response res(500, error);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            return res;
+        }
+    }
+    
+    // 正则表达式字段提取端点：带标签的DFA对每个输入做带捕获组的整串匹配，返回各组的偏移和文本
+    crow::response handleRegexExtract(const crow::request& req) {
+        auto startTime = std::chrono::steady_clock::now();
+        const size_t MAX_EXTRACT_INPUTS = 10000;
+        const size_t MAX_EXTRACT_BYTES = 1000000;
+        
+        try {
+            auto jsonBody = crow::json::load(req.body);
+            if (!jsonBody) {
+                crow::json::wvalue error;
+                error["error"] = "Invalid JSON format";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            // input 为单个输入，inputs 为多个输入，二者取其一
+            std::string regex = jsonBody.has("regex") ? std::string(jsonBody["regex"].s()) : "";
+            std::vector<std::string> inputs;
+            if (jsonBody.has("inputs")) {
+                for (size_t i = 0; i < jsonBody["inputs"].size(); ++i) {
+                    inputs.push_back(jsonBody["inputs"][i].s());
+                }
+            } else if (jsonBody.has("input")) {
+                inputs.push_back(jsonBody["input"].s());
+            }
+            
+            if (regex.empty() || inputs.empty()) {
+                crow::json::wvalue error;
+                error["error"] = "Both regex and input (or inputs) are required";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            size_t totalBytes = 0;
+            for (const auto& input : inputs) totalBytes += input.size();
+            if (regex.length() > 1000 || inputs.size() > MAX_EXTRACT_INPUTS || totalBytes > MAX_EXTRACT_BYTES) {
+                crow::json::wvalue error;
+                error["error"] = "Input too long (regex max 1000 chars, max 10000 inputs totalling 1000000 chars)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            crow::json::wvalue response;
+            if (RegexAutomata::buildFromRegex(regex)) {
+                auto extractStart = std::chrono::steady_clock::now();
+                size_t matchCount = 0;
+                response["results"] = crow::json::wvalue::list();
+                for (size_t i = 0; i < inputs.size(); ++i) {
+                    std::vector<std::pair<int, int>> groups;
+                    bool matched = RegexAutomata::extractCaptures(inputs[i], groups);
+                    response["results"][i]["matched"] = matched;
+                    response["results"][i]["groups"] = crow::json::wvalue::list();
+                    for (size_t k = 0; k < groups.size(); ++k) {
+                        const auto& [begin, end] = groups[k];
+                        response["results"][i]["groups"][k]["start"] = begin;
+                        response["results"][i]["groups"][k]["end"] = end;
+                        if (begin >= 0) {
+                            response["results"][i]["groups"][k]["text"] = inputs[i].substr(begin, end - begin);
+                        }
+                    }
+                    if (matched) matchCount++;
+                }
+                auto extractEnd = std::chrono::steady_clock::now();
+                
+                response["success"] = true;
+                response["message"] = std::to_string(matchCount) + " of " + std::to_string(inputs.size()) + " inputs match";
+                response["inputCount"] = inputs.size();
+                response["matchCount"] = matchCount;
+                response["engine"] = RegexAutomata::getLastMatchEngine();
+                response["taggedDfa"] = RegexAutomata::getTaggedDFADescription();
+                response["extractTimeMs"] = std::chrono::duration<double, std::milli>(extractEnd - extractStart).count();
+            } else {
+                response["success"] = false;
+                response["message"] = "Failed to build automata from regex: " + RegexAutomata::getLastError();
+                response["inputCount"] = inputs.size();
+                response["matchCount"] = 0;
+                response["results"] = crow::json::wvalue::list();
+            }
+            
+            auto endTime = std::chrono::steady_clock::now();
+            auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            
+            std::cout << "[INFO] Regex extract request processed in " << totalDuration.count() << "ms" << std::endl;
+            
+            crow::response res(200, response);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Content-Type", "application/json");
+            return res;
+            
+        } catch (const std::exception& e) {
+            crow::json::wvalue error;
+            error["error"] = "Internal server error: " + std::string(e.what());
+            crow::response res(500, error);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            return res;
+        }
+    }
+    
+    // 正则表达式搜索端点：在文本中查找所有最左最长、互不重叠的匹配
+    crow::response handleRegexSearch(const crow::request& req) {
+        auto startTime = std::chrono::steady_clock::now();
+        const size_t MAX_SEARCH_INPUT_LENGTH = 1000000;
+        
+        try {
+            auto jsonBody = crow::json::load(req.body);
+            if (!jsonBody) {
+                crow::json::wvalue error;
+                error["error"] = "Invalid JSON format";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            std::string regex = jsonBody["regex"].s();
+            std::string input = jsonBody.has("input") ? std::string(jsonBody["input"].s()) : "";
+            
+            if (regex.empty()) {
+                crow::json::wvalue error;
+                error["error"] = "Regex is required";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            if (regex.length() > 1000 || input.length() > MAX_SEARCH_INPUT_LENGTH) {
+                crow::json::wvalue error;
+                error["error"] = "Input too long (regex max 1000 chars, input max 1000000 chars)";
+                crow::response res(400, error);
+                res.add_header("Access-Control-Allow-Origin", "*");
+                return res;
+            }
+            
+            crow::json::wvalue response;
+            if (RegexAutomata::buildFromRegex(regex)) {
+                std::vector<RegexAutomata::SearchMatch> matches = RegexAutomata::searchAll(input);
+                
+                response["success"] = true;
+                response["message"] = "Found " + std::to_string(matches.size()) + " match(es)";
+                response["matchCount"] = matches.size();
+                response["matches"] = crow::json::wvalue::list();
+                for (size_t i = 0; i < matches.size(); ++i) {
+                    response["matches"][i]["start"] = matches[i].start;
+                    response["matches"][i]["end"] = matches[i].end;
+                    response["matches"][i]["text"] = input.substr(matches[i].start, matches[i].end - matches[i].start);
+                }
+            } else {
+                response["success"] = false;
+                response["message"] = "Failed to build automata from regex: " + RegexAutomata::getLastError();
+                response["matchCount"] = 0;
+                response["matches"] = crow::json::wvalue::list();
+            }
+            
+            auto endTime = std::chrono::steady_clock::now();
+            auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            
+            std::cout << "[INFO] Regex search request processed in " << totalDuration.count() << "ms" << std::endl;
+            
+            crow::response res(200, response);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Content-Type", "application/json");
+            return res;
+            
+        } catch (const std::exception& e) {
+            crow::json::wvalue error;
+            error["error"] = "Internal server error: " + std::string(e.what());
+            crow::response res(500, error);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            return res;
+        }
+    }
+    
     // 语法文件上传端点
     crow::response handleGrammarUpload(const crow::request& req) {
         try {
@@ -685,6 +1318,17 @@ namespace APIHandlers {
         json["nfaSvg"] = result.nfaSvg;
         json["dfaSvg"] = result.dfaSvg;
         json["minimizedDfaSvg"] = result.minimizedDfaSvg;
+        json["lazyDfa"] = result.lazyDfa;
+        if (!result.engine.empty()) {
+            json["engine"] = result.engine;
+        }
+        if (!result.captures.empty()) {
+            json["captures"] = crow::json::wvalue::list();
+            for (size_t i = 0; i < result.captures.size(); ++i) {
+                json["captures"][i]["start"] = result.captures[i].first;
+                json["captures"][i]["end"] = result.captures[i].second;
+            }
+        }
         
         return json;
     }
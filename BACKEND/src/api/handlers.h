@@ -35,13 +35,21 @@ namespace APIHandlers {
         std::string nfaSvg;
         std::string dfaSvg;
         std::string minimizedDfaSvg;
+        bool lazyDfa = false; // DFA过大未完整构建，匹配使用惰性DFA
+        std::string engine;   // 匹配使用的引擎：bitparallel、dfa、lazy-dfa、pikevm 或 counting
+        std::vector<std::pair<int, int>> captures; // Pike VM 匹配成功时的捕获组 [start, end)，0 号为整个输入
     };
     
     // API端点处理函数
     crow::response handleLR0Parse(const crow::request& req);
     crow::response handleSLR1Parse(const crow::request& req);
+    crow::response handleLL1Parse(const crow::request& req);
     crow::response handleRegexBuild(const crow::request& req);
     crow::response handleRegexMatch(const crow::request& req);
+    crow::response handleRegexMatchBatch(const crow::request& req);
+    crow::response handleRegexExtract(const crow::request& req);
+    crow::response handleRegexSearch(const crow::request& req);
+    crow::response handleRegexSet(const crow::request& req);
     crow::response handleGrammarUpload(const crow::request& req);
     crow::response handleHealthCheck(const crow::request& req);
     
@@ -51,6 +51,22 @@ namespace APIRoutes {
             return res;
         });
         
+        // LL1预测分析端点
+        CROW_ROUTE(app, "/api/ll1/parse").methods("POST"_method)
+        ([](const crow::request& req) {
+            return APIHandlers::handleLL1Parse(req);
+        });
+        
+        CROW_ROUTE(app, "/api/ll1/parse").methods("OPTIONS"_method)
+        ([](const crow::request& req) {
+            crow::response res(200);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+            res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+            res.add_header("Access-Control-Max-Age", "86400");
+            return res;
+        });
+        
         // 正则表达式构建端点
         CROW_ROUTE(app, "/api/regex/build").methods("POST"_method)
         ([](const crow::request& req) {
@@ -83,6 +99,70 @@ namespace APIRoutes {
             return res;
         });
         
+        // 正则表达式批量匹配端点
+        CROW_ROUTE(app, "/api/regex/match-batch").methods("POST"_method)
+        ([](const crow::request& req) {
+            return APIHandlers::handleRegexMatchBatch(req);
+        });
+        
+        CROW_ROUTE(app, "/api/regex/match-batch").methods("OPTIONS"_method)
+        ([](const crow::request& req) {
+            crow::response res(200);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+            res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+            res.add_header("Access-Control-Max-Age", "86400");
+            return res;
+        });
+        
+        // 正则表达式字段提取端点
+        CROW_ROUTE(app, "/api/regex/extract").methods("POST"_method)
+        ([](const crow::request& req) {
+            return APIHandlers::handleRegexExtract(req);
+        });
+        
+        CROW_ROUTE(app, "/api/regex/extract").methods("OPTIONS"_method)
+        ([](const crow::request& req) {
+            crow::response res(200);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+            res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+            res.add_header("Access-Control-Max-Age", "86400");
+            return res;
+        });
+        
+        // 正则表达式搜索端点
+        CROW_ROUTE(app, "/api/regex/search").methods("POST"_method)
+        ([](const crow::request& req) {
+            return APIHandlers::handleRegexSearch(req);
+        });
+        
+        CROW_ROUTE(app, "/api/regex/search").methods("OPTIONS"_method)
+        ([](const crow::request& req) {
+            crow::response res(200);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+            res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+            res.add_header("Access-Control-Max-Age", "86400");
+            return res;
+        });
+        
+        // 正则表达式集合端点
+        CROW_ROUTE(app, "/api/regex/set").methods("POST"_method)
+        ([](const crow::request& req) {
+            return APIHandlers::handleRegexSet(req);
+        });
+        
+        CROW_ROUTE(app, "/api/regex/set").methods("OPTIONS"_method)
+        ([](const crow::request& req) {
+            crow::response res(200);
+            res.add_header("Access-Control-Allow-Origin", "*");
+            res.add_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+            res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Requested-With");
+            res.add_header("Access-Control-Max-Age", "86400");
+            return res;
+        });
+        
         // 语法文件上传端点
         CROW_ROUTE(app, "/api/grammar/upload").methods("POST"_method)
         ([](const crow::request& req) {
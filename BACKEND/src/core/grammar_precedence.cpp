@@ -0,0 +1,80 @@
+#include "grammar_precedence.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace GrammarPrecedence {
+    // 去除字符串首尾的空白字符
+    std::string trimWhitespace(const std::string& inputString) {
+        size_t startPos = inputString.find_first_not_of(" \t\r\n");
+        size_t endPos = inputString.find_last_not_of(" \t\r\n");
+        return (startPos == std::string::npos) ? "" : inputString.substr(startPos, endPos - startPos + 1);
+    }
+
+    // 终结符：不以大写字母开头，且不是ε
+    bool isTerminal(const std::string& symbol) {
+        return !symbol.empty() && !std::isupper(symbol[0]) && symbol != "ε" && symbol != "epsilon";
+    }
+
+    bool parseDeclaration(const std::string& line, PrecedenceTable& terminalPrecedence) {
+        std::istringstream lineStream(line);
+        std::string keyword;
+        lineStream >> keyword;
+
+        Associativity associativity;
+        if (keyword == "%left") associativity = Associativity::Left;
+        else if (keyword == "%right") associativity = Associativity::Right;
+        else if (keyword == "%nonassoc") associativity = Associativity::NonAssoc;
+        else return false;
+
+        int level = 1;
+        for (const auto& entry : terminalPrecedence) {
+            level = std::max(level, entry.second.level + 1);
+        }
+
+        std::string terminal;
+        while (lineStream >> terminal) {
+            terminalPrecedence[terminal] = { level, associativity };
+        }
+        return true;
+    }
+
+    std::string extractOverride(std::string& alternativeRule) {
+        size_t precPosition = alternativeRule.find("%prec");
+        if (precPosition == std::string::npos) return "";
+
+        std::string symbol = trimWhitespace(alternativeRule.substr(precPosition + 5));
+        alternativeRule = trimWhitespace(alternativeRule.substr(0, precPosition));
+        return symbol;
+    }
+
+    ConflictResolution resolveShiftReduce(const std::vector<std::string>& rightSide, const std::string& overrideSymbol,
+                                          const std::string& terminal, const PrecedenceTable& terminalPrecedence) {
+        std::string precedenceSymbol = overrideSymbol;
+        if (precedenceSymbol.empty()) {
+            for (auto it = rightSide.rbegin(); it != rightSide.rend(); ++it) {
+                if (isTerminal(*it)) {
+                    precedenceSymbol = *it;
+                    break;
+                }
+            }
+        }
+
+        auto productionIter = terminalPrecedence.find(precedenceSymbol);
+        auto terminalIter = terminalPrecedence.find(terminal);
+        if (productionIter == terminalPrecedence.end() || terminalIter == terminalPrecedence.end()) {
+            return ConflictResolution::Unresolved;
+        }
+
+        const Precedence& productionPrec = productionIter->second;
+        const Precedence& terminalPrec = terminalIter->second;
+        if (productionPrec.level > terminalPrec.level) return ConflictResolution::Reduce;
+        if (productionPrec.level < terminalPrec.level) return ConflictResolution::Shift;
+
+        switch (terminalPrec.associativity) {
+            case Associativity::Left: return ConflictResolution::Reduce;
+            case Associativity::Right: return ConflictResolution::Shift;
+            default: return ConflictResolution::Error;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef GRAMMAR_PRECEDENCE_H
+#define GRAMMAR_PRECEDENCE_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+// LR0 与 SLR1 共用的 Yacc 风格优先级声明（%left / %right / %nonassoc / %prec）及移入-归约冲突裁决；
+// 优先级表由各分析器自己保存，这里只提供对表的操作
+namespace GrammarPrecedence {
+    enum class Associativity { Left, Right, NonAssoc };
+    struct Precedence {
+        int level;
+        Associativity associativity;
+    };
+
+    // 终结符 -> 优先级，越靠后声明的优先级越高
+    using PrecedenceTable = std::map<std::string, Precedence>;
+
+    // 移入-归约冲突的裁决结果
+    enum class ConflictResolution { Unresolved, Shift, Reduce, Error };
+
+    // 解析优先级声明行，如 "%left + -"；不是声明行时返回 false
+    bool parseDeclaration(const std::string& line, PrecedenceTable& terminalPrecedence);
+
+    // 取出可选项末尾的 "%prec 符号"，返回该符号（没有则返回空串）
+    std::string extractOverride(std::string& alternativeRule);
+
+    // 按 Yacc 规则裁决"按产生式归约"与"移入终结符"之间的冲突；产生式的优先级取 overrideSymbol（%prec 指定），
+    // 为空时取右部最右边的终结符（跳过ε）
+    ConflictResolution resolveShiftReduce(const std::vector<std::string>& rightSide, const std::string& overrideSymbol,
+                                          const std::string& terminal, const PrecedenceTable& terminalPrecedence);
+}
+
+#endif // GRAMMAR_PRECEDENCE_H
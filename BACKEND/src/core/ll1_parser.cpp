@@ -0,0 +1,407 @@
+#include "ll1_parser.h"
+#include "slr1_parser.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+// 文法数据命名空间 - 文法由SLR1Parser读取，这里保存LL(1)分析需要的副本
+namespace Grammar_LL1 {
+    std::vector<std::string> productionLeftSides;
+    std::vector<std::vector<std::string>> productionRightSides;
+    int firstProductionIndex = 0; // 跳过SLR1添加的拓广产生式
+
+    std::vector<std::string> terminalSymbols;    // 含结束符#
+    std::vector<std::string> nonterminalSymbols; // 不含拓广开始符号
+    std::map<std::string, int> terminalIndex;
+    std::map<std::string, int> nonterminalIndex;
+    std::string startSymbol;
+
+    std::map<std::string, std::set<std::string>> firstSets;
+    std::map<std::string, std::set<std::string>> followSets;
+
+    // 格式化产生式，如 "E->TA"
+    std::string formatProduction(int productionIndex) {
+        std::string text = productionLeftSides[productionIndex] + "->";
+        for (const std::string& symbol : productionRightSides[productionIndex]) {
+            text += symbol;
+        }
+        return text;
+    }
+
+    // 以 "、" 连接符号，用于提示信息
+    std::string joinSymbols(const std::vector<std::string>& symbols) {
+        std::string text;
+        for (const std::string& symbol : symbols) {
+            if (!text.empty()) text += "、";
+            text += symbol;
+        }
+        return text;
+    }
+}
+
+// 预测分析表命名空间
+namespace PredictionTable {
+    // 稠密表：table[非终结符序号 * 终结符个数 + 终结符序号] = 产生式序号，-1 表示出错
+    std::vector<int> table;
+    std::vector<LL1Parser::Conflict> conflicts;
+    std::vector<std::string> leftRecursiveNonterminals;
+
+    int& entry(int nonterminal, int terminal) {
+        return table[nonterminal * Grammar_LL1::terminalSymbols.size() + terminal];
+    }
+
+    // 计算符号串的FIRST集合
+    std::set<std::string> computeSequenceFirst(const std::vector<std::string>& symbols) {
+        std::set<std::string> result;
+        for (const std::string& symbol : symbols) {
+            if (SLR1Parser::isEpsilon(symbol)) continue;
+
+            const std::set<std::string>& symbolFirst = Grammar_LL1::firstSets[symbol];
+            for (const std::string& firstSymbol : symbolFirst) {
+                if (firstSymbol != "ε") result.insert(firstSymbol);
+            }
+            if (symbolFirst.find("ε") == symbolFirst.end()) {
+                return result;
+            }
+        }
+        result.insert("ε");
+        return result;
+    }
+
+    // 填写表项，已有不同产生式时记录冲突（保留先写入的产生式）
+    void addEntry(int productionIndex, const std::string& terminal) {
+        int row = Grammar_LL1::nonterminalIndex[Grammar_LL1::productionLeftSides[productionIndex]];
+        int column = Grammar_LL1::terminalIndex[terminal];
+        int& cell = entry(row, column);
+
+        if (cell == -1 || cell == productionIndex) {
+            cell = productionIndex;
+            return;
+        }
+
+        for (LL1Parser::Conflict& conflict : conflicts) {
+            if (conflict.nonterminal == Grammar_LL1::productionLeftSides[productionIndex] && conflict.terminal == terminal) {
+                if (std::find(conflict.productions.begin(), conflict.productions.end(), productionIndex) == conflict.productions.end()) {
+                    conflict.productions.push_back(productionIndex);
+                }
+                return;
+            }
+        }
+        conflicts.push_back({ Grammar_LL1::productionLeftSides[productionIndex], terminal, { cell, productionIndex } });
+        std::cout << "Warning: LL1 conflict at M[" << Grammar_LL1::productionLeftSides[productionIndex]
+                  << ", " << terminal << "]" << std::endl;
+    }
+
+    // 静态检测左递归：A -> β B γ 且 β 可推出 ε 时 A 可以不读入符号就展开到 B，
+    // 在这样的关系图上能回到自身的非终结符即（直接或间接）左递归，预测分析在它上面不会终止
+    void detectLeftRecursion() {
+        const int count = Grammar_LL1::nonterminalSymbols.size();
+        std::vector<std::vector<bool>> reaches(count, std::vector<bool>(count, false));
+
+        for (int i = Grammar_LL1::firstProductionIndex; i < Grammar_LL1::productionLeftSides.size(); ++i) {
+            int row = Grammar_LL1::nonterminalIndex[Grammar_LL1::productionLeftSides[i]];
+            for (const std::string& symbol : Grammar_LL1::productionRightSides[i]) {
+                if (SLR1Parser::isEpsilon(symbol)) continue;
+
+                auto nonterminalIter = Grammar_LL1::nonterminalIndex.find(symbol);
+                if (nonterminalIter == Grammar_LL1::nonterminalIndex.end()) break;
+                reaches[row][nonterminalIter->second] = true;
+
+                auto firstIter = Grammar_LL1::firstSets.find(symbol);
+                if (firstIter == Grammar_LL1::firstSets.end() || firstIter->second.count("ε") == 0) break;
+            }
+        }
+
+        // 传递闭包
+        for (int k = 0; k < count; ++k) {
+            for (int i = 0; i < count; ++i) {
+                if (!reaches[i][k]) continue;
+                for (int j = 0; j < count; ++j) {
+                    if (reaches[k][j]) reaches[i][j] = true;
+                }
+            }
+        }
+
+        leftRecursiveNonterminals.clear();
+        for (int i = 0; i < count; ++i) {
+            if (reaches[i][i]) leftRecursiveNonterminals.push_back(Grammar_LL1::nonterminalSymbols[i]);
+        }
+    }
+
+    // 构建预测分析表：A -> α 填入 M[A, a]（a ∈ FIRST(α)），若 ε ∈ FIRST(α) 再填入 M[A, b]（b ∈ FOLLOW(A)）
+    void build() {
+        table.assign(Grammar_LL1::nonterminalSymbols.size() * Grammar_LL1::terminalSymbols.size(), -1);
+        conflicts.clear();
+
+        for (int i = Grammar_LL1::firstProductionIndex; i < Grammar_LL1::productionLeftSides.size(); ++i) {
+            std::set<std::string> first = computeSequenceFirst(Grammar_LL1::productionRightSides[i]);
+            for (const std::string& terminal : first) {
+                if (terminal != "ε") addEntry(i, terminal);
+            }
+            if (first.find("ε") != first.end()) {
+                for (const std::string& terminal : Grammar_LL1::followSets[Grammar_LL1::productionLeftSides[i]]) {
+                    addEntry(i, terminal);
+                }
+            }
+        }
+
+        detectLeftRecursion();
+    }
+}
+
+// LL1Parser 命名空间 - 提供对外API接口
+namespace LL1Parser {
+    void readGrammarFromString(const std::string& grammarContent) {
+        // 只借用SLR1的文法读取和FIRST/FOLLOW计算，不影响SLR1已构建的分析表
+        SLR1Parser::GrammarAnalysis analysis = SLR1Parser::analyzeGrammar(grammarContent);
+
+        Grammar_LL1::productionLeftSides = std::move(analysis.productionLeftSides);
+        Grammar_LL1::productionRightSides = std::move(analysis.productionRightSides);
+        Grammar_LL1::firstSets = std::move(analysis.firstSets);
+        Grammar_LL1::followSets = std::move(analysis.followSets);
+
+        Grammar_LL1::firstProductionIndex = analysis.startSymbols.size();
+        Grammar_LL1::startSymbol = analysis.startSymbols.front();
+
+        // 拓广开始符号只出现在拓广产生式的左部，LL(1)分析不需要
+        std::set<std::string> augmentedSymbols;
+        for (int i = 0; i < Grammar_LL1::firstProductionIndex; ++i) {
+            augmentedSymbols.insert(Grammar_LL1::productionLeftSides[i]);
+        }
+
+        Grammar_LL1::terminalSymbols = std::move(analysis.terminalSymbols);
+        Grammar_LL1::nonterminalSymbols.clear();
+        for (const std::string& nonterminal : analysis.nonterminalSymbols) {
+            if (augmentedSymbols.find(nonterminal) == augmentedSymbols.end()) {
+                Grammar_LL1::nonterminalSymbols.push_back(nonterminal);
+            }
+        }
+
+        Grammar_LL1::terminalIndex.clear();
+        Grammar_LL1::nonterminalIndex.clear();
+        for (int i = 0; i < Grammar_LL1::terminalSymbols.size(); ++i) {
+            Grammar_LL1::terminalIndex[Grammar_LL1::terminalSymbols[i]] = i;
+        }
+        for (int i = 0; i < Grammar_LL1::nonterminalSymbols.size(); ++i) {
+            Grammar_LL1::nonterminalIndex[Grammar_LL1::nonterminalSymbols[i]] = i;
+        }
+
+        PredictionTable::build();
+    }
+
+    void readGrammarFromFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("无法打开语法文件: " + filename);
+        }
+
+        std::string content((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+        file.close();
+
+        readGrammarFromString(content);
+    }
+
+    // 构建解析表（独立于输入分析）
+    ParseResult buildParseTable() {
+        ParseResult result;
+        result.success = false;
+        result.isAccepted = false;
+        result.isLL1 = PredictionTable::conflicts.empty() && PredictionTable::leftRecursiveNonterminals.empty();
+
+        if (PredictionTable::table.empty()) {
+            result.message = "语法未初始化";
+            return result;
+        }
+
+        // 构建预测分析表结构
+        result.parseTable.headers.push_back("非终结符");
+        for (const std::string& terminal : Grammar_LL1::terminalSymbols) {
+            result.parseTable.headers.push_back(terminal);
+        }
+
+        for (int row = 0; row < Grammar_LL1::nonterminalSymbols.size(); ++row) {
+            ParseTableRow tableRow;
+            tableRow.nonterminal = Grammar_LL1::nonterminalSymbols[row];
+            for (int column = 0; column < Grammar_LL1::terminalSymbols.size(); ++column) {
+                int productionIndex = PredictionTable::entry(row, column);
+                tableRow.actions[Grammar_LL1::terminalSymbols[column]] =
+                    productionIndex == -1 ? "" : Grammar_LL1::formatProduction(productionIndex);
+            }
+            result.parseTable.rows.push_back(tableRow);
+        }
+
+        result.conflicts = PredictionTable::conflicts;
+        result.leftRecursiveNonterminals = PredictionTable::leftRecursiveNonterminals;
+        result.firstSets = Grammar_LL1::firstSets;
+        result.followSets = Grammar_LL1::followSets;
+
+        // 构建产生式信息（不含拓广产生式）
+        result.productionList.clear();
+        for (int i = Grammar_LL1::firstProductionIndex; i < Grammar_LL1::productionLeftSides.size(); ++i) {
+            result.productions[Grammar_LL1::productionLeftSides[i]].push_back(Grammar_LL1::productionRightSides[i]);
+
+            Production prod;
+            prod.index = i;
+            prod.leftSide = Grammar_LL1::productionLeftSides[i];
+            prod.rightSide = Grammar_LL1::productionRightSides[i];
+            result.productionList.push_back(prod);
+        }
+
+        result.success = true;
+        if (!result.leftRecursiveNonterminals.empty()) {
+            result.message = "文法不是LL(1)文法：" + Grammar_LL1::joinSymbols(result.leftRecursiveNonterminals) + " 存在左递归";
+        } else {
+            result.message = result.isLL1 ? "预测分析表构建成功" : "文法不是LL(1)文法，冲突表项保留第一个产生式";
+        }
+        return result;
+    }
+
+    // 解析输入字符串（非递归预测分析）
+    ParseResult parseInput(const std::string& input, const std::string& startSymbol) {
+        ParseResult result = buildParseTable();
+        if (!result.success) {
+            return result;
+        }
+
+        // 左递归的非终结符会被无限展开，预测分析不能进行
+        if (!result.leftRecursiveNonterminals.empty()) {
+            result.message = "分析错误：" + Grammar_LL1::joinSymbols(result.leftRecursiveNonterminals) + " 存在左递归，无法进行预测分析";
+            return result;
+        }
+
+        std::string entrySymbol = startSymbol.empty() ? Grammar_LL1::startSymbol : startSymbol;
+        if (Grammar_LL1::nonterminalIndex.find(entrySymbol) == Grammar_LL1::nonterminalIndex.end()) {
+            result.message = "未知的开始符号: " + entrySymbol;
+            return result;
+        }
+
+        // 准备输入串，并一次性转换为终结符序号（-1 表示非法符号）
+        std::vector<std::string> inputTokens;
+        std::istringstream iss(input);
+        std::string token;
+        while (iss >> token) {
+            inputTokens.push_back(token);
+        }
+        inputTokens.push_back("#");
+
+        std::vector<int> inputIds;
+        for (const std::string& inputToken : inputTokens) {
+            auto it = Grammar_LL1::terminalIndex.find(inputToken);
+            inputIds.push_back(it == Grammar_LL1::terminalIndex.end() ? -1 : it->second);
+        }
+
+        // 分析栈中的符号编码：终结符为 [0, T)，非终结符为 T + 非终结符序号
+        const int terminalCount = Grammar_LL1::terminalSymbols.size();
+        auto symbolName = [terminalCount](int symbol) -> const std::string& {
+            return symbol < terminalCount ? Grammar_LL1::terminalSymbols[symbol]
+                                          : Grammar_LL1::nonterminalSymbols[symbol - terminalCount];
+        };
+
+        std::vector<int> analysisStack;
+        analysisStack.push_back(Grammar_LL1::terminalIndex["#"]);
+        analysisStack.push_back(terminalCount + Grammar_LL1::nonterminalIndex[entrySymbol]);
+
+        int inputIndex = 0;
+        int step = 0;
+
+        while (true) {
+            step++;
+            int top = analysisStack.back();
+            int current = inputIds[inputIndex];
+
+            ParseStep parseStep;
+            parseStep.step = step;
+
+            std::ostringstream symbolStackStr;
+            for (int symbol : analysisStack) {
+                symbolStackStr << symbolName(symbol) << " ";
+            }
+            parseStep.symbolStack = symbolStackStr.str();
+
+            std::ostringstream remainingInputStr;
+            for (int i = inputIndex; i < inputTokens.size(); ++i) {
+                remainingInputStr << inputTokens[i] << " ";
+            }
+            parseStep.remainingInput = remainingInputStr.str();
+
+            if (current == -1) {
+                parseStep.action = "error (invalid symbol)";
+                result.parseSteps.push_back(parseStep);
+                result.message = "分析错误：非法输入符号 " + inputTokens[inputIndex];
+                return result;
+            }
+
+            if (top < terminalCount) {
+                // 栈顶为终结符：匹配或接受
+                if (top != current) {
+                    parseStep.action = "error (expected " + symbolName(top) + ")";
+                    result.parseSteps.push_back(parseStep);
+                    result.message = "分析错误：期望 " + symbolName(top);
+                    return result;
+                }
+
+                if (symbolName(top) == "#") {
+                    parseStep.action = "accept";
+                    result.parseSteps.push_back(parseStep);
+                    result.isAccepted = true;
+                    result.message = "输入被接受";
+                    return result;
+                }
+
+                parseStep.action = "match " + symbolName(top);
+                result.parseSteps.push_back(parseStep);
+                analysisStack.pop_back();
+                inputIndex++;
+            } else {
+                // 栈顶为非终结符：查表预测
+                int productionIndex = PredictionTable::entry(top - terminalCount, current);
+                if (productionIndex == -1) {
+                    parseStep.action = "error (no entry)";
+                    result.parseSteps.push_back(parseStep);
+                    result.message = "分析错误：M[" + symbolName(top) + ", " + inputTokens[inputIndex] + "] 为空";
+                    return result;
+                }
+
+                parseStep.action = "predict " + Grammar_LL1::formatProduction(productionIndex);
+                result.parseSteps.push_back(parseStep);
+
+                // 右部逆序压栈，epsilon产生式不压入任何符号
+                analysisStack.pop_back();
+                const std::vector<std::string>& rightSide = Grammar_LL1::productionRightSides[productionIndex];
+                for (auto it = rightSide.rbegin(); it != rightSide.rend(); ++it) {
+                    if (SLR1Parser::isEpsilon(*it)) continue;
+                    auto terminalIter = Grammar_LL1::terminalIndex.find(*it);
+                    analysisStack.push_back(terminalIter != Grammar_LL1::terminalIndex.end()
+                        ? terminalIter->second
+                        : terminalCount + Grammar_LL1::nonterminalIndex[*it]);
+                }
+            }
+        }
+    }
+
+    void printParseTable() {
+        std::cout << "LL(1) Parse Table:" << std::endl;
+        std::cout << std::left << std::setw(10) << "";
+        for (const std::string& terminal : Grammar_LL1::terminalSymbols) {
+            std::cout << std::left << std::setw(10) << terminal;
+        }
+        std::cout << std::endl;
+
+        for (int row = 0; row < Grammar_LL1::nonterminalSymbols.size(); ++row) {
+            std::cout << std::left << std::setw(10) << Grammar_LL1::nonterminalSymbols[row];
+            for (int column = 0; column < Grammar_LL1::terminalSymbols.size(); ++column) {
+                int productionIndex = PredictionTable::entry(row, column);
+                std::cout << std::left << std::setw(10)
+                          << (productionIndex == -1 ? "" : Grammar_LL1::formatProduction(productionIndex));
+            }
+            std::cout << std::endl;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef LL1_PARSER_H
+#define LL1_PARSER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace LL1Parser {
+    // 语法读取和处理（文法格式与SLR1一致，FIRST/FOLLOW集合复用SLR1Parser的计算结果）
+    void readGrammarFromString(const std::string& grammarContent);
+    void readGrammarFromFile(const std::string& filename);
+
+    // 解析步骤结构（与LR分析器一致；LL(1)没有状态栈，stateStack为空，symbolStack为预测分析栈）
+    struct ParseStep {
+        int step;
+        std::string stateStack;
+        std::string symbolStack;
+        std::string remainingInput;
+        std::string action;
+    };
+
+    // 预测分析表行结构：actions[终结符] = 产生式，如 "E->TA"
+    struct ParseTableRow {
+        std::string nonterminal;
+        std::map<std::string, std::string> actions;
+    };
+
+    // 分析表结构
+    struct ParseTable {
+        std::vector<std::string> headers;
+        std::vector<ParseTableRow> rows;
+    };
+
+    // 单个产生式结构（包含序号）
+    struct Production {
+        int index;
+        std::string leftSide;
+        std::vector<std::string> rightSide;
+    };
+
+    // LL(1)冲突：同一表项对应多个产生式
+    struct Conflict {
+        std::string nonterminal;
+        std::string terminal;
+        std::vector<int> productions;
+    };
+
+    // 解析相关
+    struct ParseResult {
+        bool success;
+        std::string message;
+        std::vector<ParseStep> parseSteps;
+        ParseTable parseTable;
+        bool isAccepted;
+        bool isLL1;
+        std::vector<Conflict> conflicts;
+        std::vector<std::string> leftRecursiveNonterminals; // 建表时静态检测出的左递归非终结符
+        std::map<std::string, std::vector<std::vector<std::string>>> productions;
+        std::vector<Production> productionList;
+        std::map<std::string, std::set<std::string>> firstSets;
+        std::map<std::string, std::set<std::string>> followSets;
+    };
+
+    // 构建预测分析表（独立于输入分析）
+    ParseResult buildParseTable();
+
+    // 解析输入字符串（使用已构建的预测分析表）；startSymbol为空时使用文法的开始符号
+    ParseResult parseInput(const std::string& input, const std::string& startSymbol = "");
+
+    // 调试和信息输出
+    void printParseTable();
+}
+
+#endif // LL1_PARSER_H
@@ -1,4 +1,5 @@
 #include "lr0_parser.h"
+#include "grammar_precedence.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -20,6 +21,13 @@ namespace Grammar {
     std::vector<std::string> productionLeftSides;
     std::vector<std::vector<std::string>> productionRightSides;
 
+    // 运算符优先级与结合性（%left / %right / %nonassoc 声明，越靠后声明的优先级越高）
+    GrammarPrecedence::PrecedenceTable terminalPrecedence;
+    std::map<int, std::string> productionPrecedenceSymbols; // 产生式序号 -> %prec 指定的符号
+
+    // 移入-归约冲突的裁决结果
+    using ConflictResolution = GrammarPrecedence::ConflictResolution;
+
     // 去除字符串首尾的空白字符
     std::string trimWhitespace(const std::string& inputString) {
         size_t startPos = inputString.find_first_not_of(" \t\r\n");
@@ -32,6 +40,13 @@ namespace Grammar {
         return !symbol.empty() && std::isupper(symbol[0]);
     }
 
+    // 按 Yacc 规则裁决"按产生式归约"与"移入终结符"之间的冲突
+    ConflictResolution resolveShiftReduce(int productionIndex, const std::string& terminal) {
+        auto overrideIter = productionPrecedenceSymbols.find(productionIndex);
+        return GrammarPrecedence::resolveShiftReduce(productionRightSides[productionIndex],
+            overrideIter == productionPrecedenceSymbols.end() ? "" : overrideIter->second, terminal, terminalPrecedence);
+    }
+
     // 解析产生式右部
     std::vector<std::string> parseRightHandSide(const std::string& rhs) {
         std::vector<std::string> symbols;
@@ -63,13 +78,18 @@ namespace Grammar {
             else if (std::islower(currentChar) || std::isdigit(currentChar)) {
                 currentSymbol += currentChar;
             }
-            // 处理特殊字符和操作符
+            // 处理特殊字符和操作符；ε 是两个字节的 UTF-8 字符，作为一个整体
             else {
                 if (!currentSymbol.empty()) {
                     symbols.push_back(currentSymbol);
                     currentSymbol.clear();
                 }
-                symbols.push_back(std::string(1, currentChar));
+                if (rhs.compare(i, 2, "ε") == 0) {
+                    symbols.push_back("ε");
+                    ++i;
+                } else {
+                    symbols.push_back(std::string(1, currentChar));
+                }
             }
         }
 
@@ -95,6 +115,7 @@ namespace Grammar {
         std::vector<std::pair<std::string, std::string>> rawProductionRules;
         std::string startSymbol;
         bool hasStartSymbolS = false;
+        terminalPrecedence.clear();
 
         // 读取每一行并解析产生式
         int lineNumber = 0;
@@ -105,6 +126,9 @@ namespace Grammar {
             // 跳过空行和注释 find 返回子串出现的第一个位置index
             if (currentLine.empty() || currentLine.find("//") == 0) continue;
 
+            // 优先级声明
+            if (GrammarPrecedence::parseDeclaration(currentLine, terminalPrecedence)) continue;
+
             // 查找箭头符号
             size_t arrowPosition = currentLine.find("->");
             if (arrowPosition == std::string::npos) {
@@ -144,6 +168,7 @@ namespace Grammar {
         // 清空原有数据，重新构建
         productionLeftSides.clear();
         productionRightSides.clear();
+        productionPrecedenceSymbols.clear();
         nonterminalSymbols.clear();
         terminalSymbols.clear();
         allSymbols.clear();
@@ -171,6 +196,7 @@ namespace Grammar {
                 alternativeRule = trimWhitespace(alternativeRule);
                 if (alternativeRule.empty()) continue;
 
+                std::string precedenceSymbol = GrammarPrecedence::extractOverride(alternativeRule);
                 std::vector<std::string> symbols = parseRightHandSide(alternativeRule);
 
                 if (symbols.empty()) continue;
@@ -185,6 +211,9 @@ namespace Grammar {
                     }
                 }
 
+                if (!precedenceSymbol.empty()) {
+                    productionPrecedenceSymbols[productionLeftSides.size()] = precedenceSymbol;
+                }
                 productionLeftSides.push_back(productionPair.first);
                 productionRightSides.push_back(symbols);
             }
@@ -218,6 +247,7 @@ namespace Grammar {
         std::vector<std::pair<std::string, std::string>> rawProductionRules;
         std::string startSymbol;
         bool hasStartSymbolS = false;
+        terminalPrecedence.clear();
 
         std::istringstream grammarStream(grammarContent);
         std::string currentLine;
@@ -229,6 +259,8 @@ namespace Grammar {
 
             if (currentLine.empty() || currentLine.find("//") == 0) continue;
 
+            if (GrammarPrecedence::parseDeclaration(currentLine, terminalPrecedence)) continue;
+
             size_t arrowPosition = currentLine.find("->");
             if (arrowPosition == std::string::npos) {
                 continue;
@@ -260,6 +292,7 @@ namespace Grammar {
         // 清空原有数据，重新构建
         productionLeftSides.clear();
         productionRightSides.clear();
+        productionPrecedenceSymbols.clear();
         nonterminalSymbols.clear();
         terminalSymbols.clear();
         allSymbols.clear();
@@ -285,6 +318,7 @@ namespace Grammar {
                 alternativeRule = trimWhitespace(alternativeRule);
                 if (alternativeRule.empty()) continue;
 
+                std::string precedenceSymbol = GrammarPrecedence::extractOverride(alternativeRule);
                 std::vector<std::string> symbols = parseRightHandSide(alternativeRule);
                 if (symbols.empty()) continue;
 
@@ -296,6 +330,9 @@ namespace Grammar {
                     }
                 }
 
+                if (!precedenceSymbol.empty()) {
+                    productionPrecedenceSymbols[productionLeftSides.size()] = precedenceSymbol;
+                }
                 productionLeftSides.push_back(productionPair.first);
                 productionRightSides.push_back(symbols);
             }
@@ -817,6 +854,7 @@ namespace LR0Analyzer {
         std::cout << "=======================" << std::endl;
         for (int stateIndex = 0; stateIndex < numberOfStates; stateIndex++) {
             std::cout << "Processing state " << stateIndex << ":" << std::endl;
+            std::set<std::string> nonassocErrors; // 因 %nonassoc 被置为错误的终结符，后续不再填写
             for (auto currentItem : canonicalCollection[stateIndex]) {
                 int productionIndex = currentItem.productionIndex;
                 int dotPosition = currentItem.dotPosition;
@@ -838,8 +876,23 @@ namespace LR0Analyzer {
                                     break;
                                 }
                             }
-                            if (targetStateIndex < numberOfStates) {
-                                actionTable[stateIndex][symbolAfterDot] = "s" + std::to_string(targetStateIndex);
+                            if (targetStateIndex < numberOfStates && nonassocErrors.count(symbolAfterDot) == 0) {
+                                // 已有归约动作时按优先级裁决，无优先级信息则保持移入覆盖
+                                const std::string& existingAction = actionTable[stateIndex][symbolAfterDot];
+                                Grammar::ConflictResolution resolution = Grammar::ConflictResolution::Unresolved;
+                                if (!existingAction.empty() && existingAction[0] == 'r') {
+                                    resolution = Grammar::resolveShiftReduce(std::stoi(existingAction.substr(1)), symbolAfterDot);
+                                }
+
+                                if (resolution == Grammar::ConflictResolution::Error) {
+                                    std::cout << "    Nonassoc conflict on " << symbolAfterDot << ", set error" << std::endl;
+                                    actionTable[stateIndex][symbolAfterDot] = "";
+                                    nonassocErrors.insert(symbolAfterDot);
+                                } else if (resolution == Grammar::ConflictResolution::Reduce) {
+                                    std::cout << "    Keep reduce on " << symbolAfterDot << " by precedence" << std::endl;
+                                } else {
+                                    actionTable[stateIndex][symbolAfterDot] = "s" + std::to_string(targetStateIndex);
+                                }
                             }
                         }
                     }
@@ -876,8 +929,26 @@ namespace LR0Analyzer {
 
                         // 对所有终结符设置归约操作
                         for (const std::string& terminal : Grammar::terminalSymbols) {
-                            if (terminal != "#" && actionTable[stateIndex][terminal] == "") {
-                                actionTable[stateIndex][terminal] = "r" + std::to_string(productionIndex);
+                            if (terminal == "#" || nonassocErrors.count(terminal) > 0) continue;
+
+                            std::string& existingAction = actionTable[stateIndex][terminal];
+                            if (!existingAction.empty() && existingAction[0] == 's') {
+                                // 移入-归约冲突：按优先级和结合性裁决
+                                switch (Grammar::resolveShiftReduce(productionIndex, terminal)) {
+                                    case Grammar::ConflictResolution::Reduce:
+                                        std::cout << "    Reduce on " << terminal << " by precedence" << std::endl;
+                                        existingAction = "r" + std::to_string(productionIndex);
+                                        break;
+                                    case Grammar::ConflictResolution::Error:
+                                        std::cout << "    Nonassoc conflict on " << terminal << ", set error" << std::endl;
+                                        existingAction = "";
+                                        nonassocErrors.insert(terminal);
+                                        break;
+                                    default:
+                                        break;
+                                }
+                            } else if (existingAction == "") {
+                                existingAction = "r" + std::to_string(productionIndex);
                             }
                         }
                         actionTable[stateIndex]["#"] = "r" + std::to_string(productionIndex);
@@ -8,634 +8,3698 @@
 #include <tuple>
 #include <stack>
 #include <queue>
+#include <unordered_map>
 #include <algorithm>
 #include <fstream>
 #include <string>
 #include <numeric>
 #include <sstream>
-
-// 常量和全局类型定义
-namespace Constants {
-    const int N = 135;
-    
-    // 字符映射表
-    const std::vector<int> CHARACTER_INDEX = {
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 
-        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 
-        'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 
-        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 
-        'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'
-    };
-}
+#include <cstdint>
+#include <stdexcept>
+#include <memory>
+#include <cctype>
+#include <deque>
+#include <chrono>
+#include <array>
+#include <cstring>
 
 // 数据结构定义
 namespace DataStructures {
-    class NFAState {
+    // 紧凑自动机（CSR存储）：状态 i 的转移位于 [transition_offsets[i], transition_offsets[i + 1])，
+    // 每条转移标记一个字节区间 [transition_lo, transition_hi]，同一状态内按区间起点排序；
+    // ε转移单独存放在 epsilon_offsets / epsilon_targets 中。
+    // 构建阶段先把边追加到待处理列表，finalize() 后一次性排成CSR，之后只读
+    class CompactAutomaton {
     public:
-        std::vector<int> edges[Constants::N];
-        bool accept_state = false;
-    };
+        int state_count = 0;
+        std::vector<char> accept_states;
+        std::vector<int> transition_offsets;
+        std::vector<unsigned char> transition_lo;
+        std::vector<unsigned char> transition_hi;
+        std::vector<int> transition_targets;
+        std::vector<int> epsilon_offsets;
+        std::vector<int> epsilon_targets;
+        std::vector<int> save_offsets;
+        std::vector<int> save_slots;
 
-    class DFAState {
-    public:
-        std::vector<int> edges[Constants::N];
-        bool accept_state = false;
-    };
-    
-    // 全局变量
-    std::vector<NFAState> nfa_states;
-    std::vector<DFAState> dfa_states;
-    std::stack<int> state_stack;
-    std::set<char> alphabet;
-}
+        // 计数器：counters[i].state 上的区间自环每走一次计数加一（不超过 max，max 为 -1 表示无上限），
+        // 该状态的ε转移只在计数不小于 min 时可走；子集构造不认识计数器，含计数器的NFA只能用计数模拟
+        struct Counter {
+            int state;
+            int min;
+            int max;
+        };
+        std::vector<Counter> counters;
+        std::vector<int> counter_of; // 状态 -> 计数器下标，finalize() 后有效，-1 表示普通状态
+
+        int add_state() {
+            accept_states.push_back(0);
+            return state_count++;
+        }
+
+        void add_transition(int from, unsigned char lo, unsigned char hi, int to) {
+            pending_transitions.push_back({from, lo, hi, to});
+        }
+
+        void add_epsilon(int from, int to) {
+            pending_epsilons.push_back({from, to});
+        }
 
-// 输入验证模块
-namespace InputValidator {
-    void validate_input(const std::string &str) {
-        // 收集字母表
-        for (const auto &c : str) {
-            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
-                DataStructures::alphabet.insert(c);
+        // 捕获组：进入状态 state 时把当前位置记入 slot（仅NFA模拟使用，子集构造忽略）
+        void add_save(int state, int slot) {
+            pending_saves.push_back({state, slot});
+        }
+
+        void add_counter(int state, int min, int max) {
+            counters.push_back({state, min, max});
+        }
+
+        // 把待处理的边排成CSR（按起点稳定排序，保留同一状态内边的加入顺序）
+        void finalize() {
+            std::stable_sort(pending_transitions.begin(), pending_transitions.end(),
+                [](const auto &a, const auto &b) {
+                    if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+                    return std::get<1>(a) < std::get<1>(b);
+                });
+            std::stable_sort(pending_epsilons.begin(), pending_epsilons.end(),
+                [](const auto &a, const auto &b) { return a.first < b.first; });
+
+            transition_offsets.assign(state_count + 1, 0);
+            transition_lo.clear();
+            transition_hi.clear();
+            transition_targets.clear();
+            transition_lo.reserve(pending_transitions.size());
+            transition_hi.reserve(pending_transitions.size());
+            transition_targets.reserve(pending_transitions.size());
+            for (const auto &[from, lo, hi, to] : pending_transitions) {
+                transition_offsets[from + 1]++;
+                transition_lo.push_back(lo);
+                transition_hi.push_back(hi);
+                transition_targets.push_back(to);
             }
-            
-            // 检查合法字符
-            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
-                  c == '(' || c == ')' || c == '*' || c == '|')) {
-                std::cout << "非法输入\n表示标识符的正规式 （标识符： 以字母开头， 由字母和数字构成的字符串）\n";
-                return;
+            std::partial_sum(transition_offsets.begin(), transition_offsets.end(), transition_offsets.begin());
+
+            epsilon_offsets.assign(state_count + 1, 0);
+            epsilon_targets.clear();
+            epsilon_targets.reserve(pending_epsilons.size());
+            for (const auto &[from, to] : pending_epsilons) {
+                epsilon_offsets[from + 1]++;
+                epsilon_targets.push_back(to);
             }
+            std::partial_sum(epsilon_offsets.begin(), epsilon_offsets.end(), epsilon_offsets.begin());
+
+            std::stable_sort(pending_saves.begin(), pending_saves.end(),
+                [](const auto &a, const auto &b) { return a.first < b.first; });
+            save_offsets.assign(state_count + 1, 0);
+            save_slots.clear();
+            for (const auto &[state, slot] : pending_saves) {
+                save_offsets[state + 1]++;
+                save_slots.push_back(slot);
+            }
+            std::partial_sum(save_offsets.begin(), save_offsets.end(), save_offsets.begin());
+
+            counter_of.assign(state_count, -1);
+            for (size_t i = 0; i < counters.size(); i++) {
+                counter_of[counters[i].state] = i;
+            }
+
+            std::vector<std::tuple<int, unsigned char, unsigned char, int>>().swap(pending_transitions);
+            std::vector<std::pair<int, int>>().swap(pending_epsilons);
+            std::vector<std::pair<int, int>>().swap(pending_saves);
         }
-    }
-}
 
-// 正则表达式预处理模块
-namespace RegexPreprocessor {
-    std::string add_concatenation(const std::string &regexp) {
-        std::string result;
-        char current, next;
-        
-        for (auto it = regexp.begin(); it != regexp.end(); ++it) {
-            current = *it;
-            if (it + 1 != regexp.end()) {
-                next = *(it + 1);
-                result.push_back(current);
-                if (current != '(' && next != ')' && current != '|' && 
-                    next != '|' && next != '*') {
-                    result.push_back('.');
-                }
+        bool accepts_byte(int k, unsigned char byte) const {
+            return transition_lo[k] <= byte && byte <= transition_hi[k];
+        }
+
+        // 确定性自动机上的单步转移，没有转移时返回 -1
+        int find_transition(int state, unsigned char byte) const {
+            for (int k = transition_offsets[state]; k < transition_offsets[state + 1]; ++k) {
+                if (accepts_byte(k, byte)) return transition_targets[k];
             }
+            return -1;
         }
-        result.push_back(regexp.back());
-        return result;
-    }
-}
 
-// 正则表达式转换模块
-namespace RegexConverter {
-    int get_operator_priority(const char &c) {
-        switch (c) {
-            case '*': return 3;
-            case '.': return 2;
-            case '|': return 1;
-            default: return 0;
+        size_t memory_usage() const {
+            return accept_states.capacity() * sizeof(char) +
+                   (transition_offsets.capacity() + transition_targets.capacity() +
+                    epsilon_offsets.capacity() + epsilon_targets.capacity() +
+                    save_offsets.capacity() + save_slots.capacity()) * sizeof(int) +
+                   (transition_lo.capacity() + transition_hi.capacity()) * sizeof(unsigned char);
         }
-    }
+
+        void clear() {
+            *this = CompactAutomaton();
+        }
+
+    private:
+        std::vector<std::tuple<int, unsigned char, unsigned char, int>> pending_transitions;
+        std::vector<std::pair<int, int>> pending_epsilons;
+        std::vector<std::pair<int, int>> pending_saves;
+    };
     
-    std::string infix_to_postfix(const std::string &regexp) {
-        std::string result;
-        std::stack<char> operators;
-        
-        for (const auto &c : regexp) {
-            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
-                result.push_back(c);
-            }
-            else if (c == '(') {
-                operators.push(c);
+    // 字节类：按所有转移区间的端点把 0-255 切成若干连续区间，同一类中的字节在每条转移上的表现都相同。
+    // ranges 为各类的 [lo, hi]，class_of[b] 为字节 b 所属的类，covered[c] 表示类 c 至少被一条转移覆盖
+    struct ByteClasses {
+        std::vector<std::pair<unsigned char, unsigned char>> ranges;
+        std::vector<char> covered;
+        std::vector<int> class_of = std::vector<int>(256, 0);
+
+        explicit ByteClasses(const CompactAutomaton &automaton) {
+            std::vector<char> boundary(257, 0);
+            boundary[0] = 1;
+            for (size_t k = 0; k < automaton.transition_lo.size(); k++) {
+                boundary[automaton.transition_lo[k]] = 1;
+                boundary[automaton.transition_hi[k] + 1] = 1;
             }
-            else if (c == ')') {
-                while (!operators.empty() && operators.top() != '(') {
-                    result.push_back(operators.top());
-                    operators.pop();
-                }
-                if (!operators.empty()) operators.pop(); // 弹出 '('
+            for (int byte = 0; byte < 256; byte++) {
+                if (byte > 0 && boundary[byte]) ranges.back().second = byte - 1;
+                if (boundary[byte]) ranges.push_back({byte, 255});
+                class_of[byte] = ranges.size() - 1;
             }
-            else {
-                while (!operators.empty() && operators.top() != '(' && 
-                       get_operator_priority(operators.top()) >= get_operator_priority(c)) {
-                    result.push_back(operators.top());
-                    operators.pop();
+            covered.assign(ranges.size(), 0);
+            for (size_t k = 0; k < automaton.transition_lo.size(); k++) {
+                for (int c = class_of[automaton.transition_lo[k]]; c <= class_of[automaton.transition_hi[k]]; c++) {
+                    covered[c] = 1;
                 }
-                operators.push(c);
             }
         }
-        
-        while (!operators.empty()) {
-            result.push_back(operators.top());
-            operators.pop();
-        }
-        
-        return result;
+
+        int count() const { return ranges.size(); }
+    };
+
+    // 转移区间的显示标签：可打印字符原样显示，其余字节显示为 \xHH
+    std::string byte_label(unsigned char byte) {
+        static const char *hex = "0123456789ABCDEF";
+        if (byte == '\\' || byte == '"') return std::string("\\") + (char)byte;
+        if (byte >= 0x21 && byte < 0x7F) return std::string(1, (char)byte);
+        return std::string("\\x") + hex[byte >> 4] + hex[byte & 15];
     }
-}
 
-// NFA构建模块
-namespace NFAConstructor {
-    int state_index = 0;
-    
-    void create_character_nfa(const char &c) {
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
-        
-        DataStructures::nfa_states[state_index].edges[c].push_back(state_index + 1);
-        DataStructures::state_stack.push(state_index++);
-        DataStructures::state_stack.push(state_index++);
+    std::string range_label(unsigned char lo, unsigned char hi) {
+        if (lo == hi) return byte_label(lo);
+        return "[" + byte_label(lo) + "-" + byte_label(hi) + "]";
     }
-    
-    void create_or_nfa() {
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
 
-        int d = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int c = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+    const std::string EPSILON_LABEL = "ε";
 
-        DataStructures::nfa_states[state_index].edges['#'].push_back(a);
-        DataStructures::nfa_states[state_index].edges['#'].push_back(c);
-        DataStructures::state_stack.push(state_index++);
-        
-        DataStructures::nfa_states[b].edges['#'].push_back(state_index);
-        DataStructures::nfa_states[d].edges['#'].push_back(state_index);
-        DataStructures::state_stack.push(state_index++);
+    // 全局变量
+    CompactAutomaton nfa;
+    CompactAutomaton dfa;
+    std::stack<int> state_stack;
+}
+
+// 正则表达式语法分析模块 - 递归下降生成抽象语法树
+//   alternation := concatenation ('|' concatenation)*
+//   concatenation := repetition*
+//   repetition := atom ('*' | '+' | '?' | '{m}' | '{m,}' | '{m,n}')*
+//   atom := '(' alternation ')' | '[' class ']' | '.' | '\' escape | 其他字节
+namespace RegexParser {
+    using ByteRanges = std::vector<std::pair<unsigned char, unsigned char>>;
+    using CodepointRanges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    const uint32_t MAX_CODEPOINT = 0x10FFFF;
+
+    // Intersect 与 Complement 只在扩展语法（导数构造）中出现
+    enum class NodeType { Empty, Class, Concat, Alternate, Star, Plus, Optional, Group, Repeat, Intersect, Complement };
+
+    const int MAX_REPEAT = 100000; // {m,n} 中允许的最大边界
+
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+
+    struct Node {
+        NodeType type;
+        ByteRanges ranges;              // Class：有序、互不相交且不相邻的字节区间
+        std::vector<NodePtr> children;
+        int group = 0;                  // Group：捕获组编号，按左括号顺序从1开始
+        int min = 0;                    // Repeat：重复次数下界
+        int max = -1;                   // Repeat：重复次数上界，-1 表示无上界
+    };
+
+    NodePtr make_node(NodeType type, std::vector<NodePtr> children = {}) {
+        auto node = std::make_shared<Node>();
+        node->type = type;
+        node->children = std::move(children);
+        return node;
     }
-    
-    void create_concatenation_nfa() {
-        int d = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int c = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        
-        DataStructures::nfa_states[b].edges['#'].push_back(c);
-        DataStructures::state_stack.push(a);
-        DataStructures::state_stack.push(d);
+
+    // 排序并合并重叠或相邻的区间
+    template <typename Ranges>
+    Ranges normalize(Ranges ranges) {
+        std::sort(ranges.begin(), ranges.end());
+        Ranges merged;
+        for (const auto &range : ranges) {
+            if (!merged.empty() && range.first <= merged.back().second + 1) {
+                merged.back().second = std::max(merged.back().second, range.second);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
     }
-    
-    void create_kleene_star_nfa() {
-        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
-        
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
-        DataStructures::nfa_states.push_back(DataStructures::NFAState());
-        
-        DataStructures::nfa_states[b].edges['#'].push_back(a);
-        DataStructures::nfa_states[state_index].edges['#'].push_back(a);
-        DataStructures::nfa_states[state_index].edges['#'].push_back(state_index + 1);
-        DataStructures::nfa_states[b].edges['#'].push_back(state_index + 1);
-        
-        DataStructures::state_stack.push(state_index++);
-        DataStructures::state_stack.push(state_index++);
+
+    ByteRanges negate(const ByteRanges &ranges) {
+        ByteRanges result;
+        int next = 0;
+        for (const auto &range : normalize(ranges)) {
+            if (range.first > next) result.push_back({next, range.first - 1});
+            next = range.second + 1;
+        }
+        if (next <= 255) result.push_back({next, 255});
+        return result;
     }
-    
-    void build_nfa_from_postfix(const std::string &postfix) {
-        for (const auto &c : postfix) {
-            switch (c) {
-                case '*':
-                    create_kleene_star_nfa();
-                    break;
-                case '.':
-                    create_concatenation_nfa();
-                    break;
-                case '|':
-                    create_or_nfa();
-                    break;
-                default:
-                    create_character_nfa(c);
-                    break;
-            }
+
+    NodePtr make_class(const ByteRanges &ranges) {
+        auto node = make_node(NodeType::Class);
+        node->ranges = normalize(ranges);
+        return node;
+    }
+
+    CodepointRanges negate_codepoints(const CodepointRanges &ranges) {
+        CodepointRanges result;
+        uint32_t next = 0;
+        for (const auto &range : normalize(ranges)) {
+            if (range.first > next) result.push_back({next, range.first - 1});
+            next = range.second + 1;
         }
+        if (next <= MAX_CODEPOINT) result.push_back({next, MAX_CODEPOINT});
+        return result;
     }
-}
 
-// NFA管理模块
-namespace NFAManager {
-    std::vector<int> states;
-    std::set<int> non_initial_states;
-    int initial_state;
-    std::set<int> accept_states;
-    std::vector<std::tuple<int, char, int>> transitions;
-    
-    void initialize() {
-        states.resize(DataStructures::nfa_states.size());
-        std::iota(states.begin(), states.end(), 0);
+    // 码点的UTF-8编码
+    std::vector<unsigned char> encode_utf8(uint32_t cp) {
+        if (cp < 0x80) return {(unsigned char)cp};
+        if (cp < 0x800) return {(unsigned char)(0xC0 | (cp >> 6)), (unsigned char)(0x80 | (cp & 0x3F))};
+        if (cp < 0x10000) {
+            return {(unsigned char)(0xE0 | (cp >> 12)), (unsigned char)(0x80 | ((cp >> 6) & 0x3F)),
+                    (unsigned char)(0x80 | (cp & 0x3F))};
+        }
+        return {(unsigned char)(0xF0 | (cp >> 18)), (unsigned char)(0x80 | ((cp >> 12) & 0x3F)),
+                (unsigned char)(0x80 | ((cp >> 6) & 0x3F)), (unsigned char)(0x80 | (cp & 0x3F))};
+    }
 
-        for (int i = 0; i < DataStructures::nfa_states.size(); i++) {
-            auto &[edges, accept_state] = DataStructures::nfa_states[i];
-            
-            // 处理字符转移
-            for (auto index : Constants::CHARACTER_INDEX) {
-                if (!edges[index].empty()) {
-                    for (auto j : edges[index]) {
-                        transitions.push_back({i, (char)index, j});
-                        non_initial_states.insert(j);
-                    }
-                }
+    // 把码点区间 [lo, hi] 切分为UTF-8字节区间序列：每个序列逐字节给出取值区间，
+    // 序列之间互不相交且按编码顺序排列。先在编码长度边界处切开，再切到除首字节外
+    // 每个续字节都取满 [80, BF] 或首尾字节前缀相同为止；代理区 D800-DFFF 不编码
+    void utf8_sequences(uint32_t lo, uint32_t hi, std::vector<ByteRanges> &sequences) {
+        if (lo > hi) return;
+        if (lo <= 0xDFFF && hi >= 0xD800) {
+            if (lo < 0xD800) utf8_sequences(lo, 0xD7FF, sequences);
+            if (hi > 0xDFFF) utf8_sequences(0xE000, hi, sequences);
+            return;
+        }
+        for (uint32_t boundary : {0x7Fu, 0x7FFu, 0xFFFFu}) {
+            if (lo <= boundary && hi > boundary) {
+                utf8_sequences(lo, boundary, sequences);
+                utf8_sequences(boundary + 1, hi, sequences);
+                return;
             }
-            
-            // 处理epsilon转移
-            if (!edges['#'].empty()) {
-                for (auto j : edges['#']) {
-                    transitions.push_back({i, '#', j});
-                    non_initial_states.insert(j);
+        }
+        if (hi < 0x80) {
+            sequences.push_back({{(unsigned char)lo, (unsigned char)hi}});
+            return;
+        }
+        for (int i = 1; i < 4; i++) {
+            uint32_t mask = (1u << (6 * i)) - 1;
+            if ((lo & ~mask) != (hi & ~mask)) {
+                if ((lo & mask) != 0) {
+                    utf8_sequences(lo, lo | mask, sequences);
+                    utf8_sequences((lo | mask) + 1, hi, sequences);
+                    return;
+                }
+                if ((hi & mask) != mask) {
+                    utf8_sequences(lo, (hi & ~mask) - 1, sequences);
+                    utf8_sequences(hi & ~mask, hi, sequences);
+                    return;
                 }
             }
         }
+        std::vector<unsigned char> first = encode_utf8(lo), last = encode_utf8(hi);
+        ByteRanges sequence;
+        for (size_t i = 0; i < first.size(); i++) sequence.push_back({first[i], last[i]});
+        sequences.push_back(sequence);
+    }
 
-        // 找到初始状态
-        for (int i = 0; i < DataStructures::nfa_states.size(); i++) {
-            if (non_initial_states.find(i) == non_initial_states.end()) {
-                initial_state = i;
-                break;
+    // 把首 depth 个字节区间相同的一组序列建成前缀树：[begin, end) 内按第 depth 个字节区间分组，
+    // 在此结束的分支合并成一个字符类，其余分支为 "字符类 + 子树"
+    NodePtr build_sequence_tree(const std::vector<ByteRanges> &sequences, size_t begin, size_t end, size_t depth) {
+        ByteRanges finished;
+        std::vector<NodePtr> branches;
+        for (size_t i = begin; i < end;) {
+            size_t j = i + 1;
+            while (j < end && sequences[j][depth] == sequences[i][depth]) j++;
+            if (sequences[i].size() == depth + 1) {
+                finished.push_back(sequences[i][depth]);
+            } else {
+                NodePtr head = make_class({sequences[i][depth]});
+                branches.push_back(make_node(NodeType::Concat, {head, build_sequence_tree(sequences, i, j, depth + 1)}));
             }
+            i = j;
         }
+        if (!finished.empty() || branches.empty()) branches.insert(branches.begin(), make_class(finished));
+        return branches.size() == 1 ? branches[0] : make_node(NodeType::Alternate, std::move(branches));
+    }
 
-        // 找到接受状态
-        for (int i = 0; i < DataStructures::nfa_states.size(); i++) {
-            const auto &[edges, accept_state] = DataStructures::nfa_states[i];
-            if (accept_state) {
-                accept_states.insert(i);
-            }
+    // 码点字符类：编译为匹配对应UTF-8字节序列的子表达式
+    NodePtr make_codepoint_class(const CodepointRanges &ranges) {
+        std::vector<ByteRanges> sequences;
+        for (const auto &[lo, hi] : normalize(ranges)) {
+            utf8_sequences(lo, hi, sequences);
         }
+        return build_sequence_tree(sequences, 0, sequences.size(), 0);
     }
-    
-    void print_nfa() {
-        std::cout << "=== NFA ===\n";
-        std::cout << "States: ";
-        for (const auto &i : states) {
-            std::cout << i << ' ';
-        }
-        std::cout << '\n';
 
-        std::cout << "Alphabet: ";
-        for (const auto &i : DataStructures::alphabet) {
-            std::cout << i << ' ';
+    class Parser {
+    public:
+        // extended 为 true 时 '&' 表示交、前缀 '~' 表示补，否则二者是普通字符
+        explicit Parser(const std::string &regex, bool extended = false) : pattern(regex), extended(extended) {}
+
+        NodePtr parse() {
+            NodePtr root = parse_alternation();
+            if (pos < pattern.size()) error("Unmatched ')'");
+            return root;
         }
-        std::cout << '\n';
 
-        std::cout << "Initial state: " << initial_state << '\n';
+        int group_count() const { return groups; }
 
-        std::cout << "Transitions: ";
-        for (const auto &[from, symbol, to] : transitions) {
-            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+    private:
+        const std::string &pattern;
+        bool extended;
+        size_t pos = 0;
+        int groups = 0;
+        bool saw_unicode = false; // 当前字符类（或转义）含有非ASCII码点
+        bool saw_raw = false;     // 当前字符类含有不构成UTF-8字符的非ASCII字节
+
+        [[noreturn]] void error(const std::string &message) const {
+            throw std::runtime_error(message + " at position " + std::to_string(pos));
         }
-        std::cout << '\n';
 
-        std::cout << "Accept states: ";
-        for (const auto &i : accept_states) {
-            std::cout << i << ' ';
+        bool at_end() const { return pos >= pattern.size(); }
+        unsigned char peek() const { return pattern[pos]; }
+
+        // 解码从 at 开始的多字节UTF-8字符，返回其字节数；不是合法的多字节编码时返回 0
+        size_t decode_utf8(size_t at, uint32_t &cp) const {
+            unsigned char lead = pattern[at];
+            size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+            if (length == 0 || lead > 0xF4 || at + length > pattern.size()) return 0;
+            cp = lead & (0x7F >> length);
+            for (size_t i = 1; i < length; i++) {
+                unsigned char next = pattern[at + i];
+                if ((next & 0xC0) != 0x80) return 0;
+                cp = (cp << 6) | (next & 0x3F);
+            }
+            static const uint32_t smallest[] = {0, 0, 0x80, 0x800, 0x10000};
+            if (cp < smallest[length] || cp > MAX_CODEPOINT || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+            return length;
         }
-        std::cout << '\n';
-    }
-}
 
-// DFA转换模块
-namespace DFAConverter {
-    void compute_epsilon_closure(int state, std::set<int> &closure) {
-        const auto &[edges, accept_state] = DataStructures::nfa_states[state];
-        for (auto next_state : edges['#']) {
-            if (closure.find(next_state) == closure.end()) {
-                closure.insert(next_state);
-                compute_epsilon_closure(next_state, closure);
+        int read_hex(size_t digits, const char *what) {
+            int value = 0;
+            for (size_t i = 0; i < digits; i++) {
+                if (at_end() || !std::isxdigit(peek())) error(std::string("Invalid ") + what + " escape");
+                unsigned char digit = pattern[pos++];
+                value = value * 16 + (std::isdigit(digit) ? digit - '0' : std::tolower(digit) - 'a' + 10);
             }
+            return value;
         }
-    }
-    
-    void print_epsilon_closures(int n, std::set<int>* eps) {
-        std::cout << "=== Epsilon Closures ===\n";
-        for (int i = 0; i < n; i++) {
-            std::cout << i << ": ";
-            for (const auto &j : eps[i]) {
-                std::cout << j << ' ';
+
+        // 字节类（码点都小于 0x100）只保留字节部分，取反形式的 \D 等因此仍按字节取反
+        static ByteRanges to_bytes(const CodepointRanges &ranges) {
+            ByteRanges bytes;
+            for (const auto &[lo, hi] : ranges) {
+                if (lo <= 0xFF) bytes.push_back({(unsigned char)lo, (unsigned char)std::min<uint32_t>(hi, 0xFF)});
             }
-            std::cout << '\n';
+            return bytes;
         }
-        std::cout << "========================\n";
-    }
-    
-    void convert_nfa_to_dfa(int start_state, int nfa_size) {
-        DataStructures::dfa_states.clear();
-        std::map<std::set<int>, int> state_map;
-        std::map<std::set<int>, bool> visited;
-        
-        // 计算每个状态的epsilon闭包
-        std::vector<std::set<int>> epsilon_closures(nfa_size);
-        for (int i = 0; i < nfa_size; i++) {
-            epsilon_closures[i].insert(i); // 自己也在epsilon闭包中
-            compute_epsilon_closure(i, epsilon_closures[i]);
+
+        NodePtr parse_alternation() {
+            std::vector<NodePtr> branches = {parse_intersection()};
+            while (!at_end() && peek() == '|') {
+                pos++;
+                branches.push_back(parse_intersection());
+            }
+            return branches.size() == 1 ? branches[0] : make_node(NodeType::Alternate, std::move(branches));
         }
-        
-        std::set<int> initial_set = epsilon_closures[start_state];
-        state_map[initial_set] = 0;
-        DataStructures::dfa_states.push_back(DataStructures::DFAState());
-        
-        print_epsilon_closures(nfa_size, epsilon_closures.data());
-        
-        std::queue<std::set<int>> queue;
-        queue.push(initial_set);
-        int dfa_state_count = 0;
-        
-        while (!queue.empty()) {
-            auto current_set = queue.front();
-            queue.pop();
-            
-            if (visited[current_set]) continue;
-            visited[current_set] = true;
-            
-            for (const auto &symbol : DataStructures::alphabet) {
-                std::set<int> next_set;
-                
-                // 对当前集合中的每个状态，找到通过symbol能到达的状态
-                for (const auto &state : current_set) {
-                    for (auto next_state : DataStructures::nfa_states[state].edges[symbol]) {
-                        // 添加到达状态及其epsilon闭包
-                        for (const auto &closure_state : epsilon_closures[next_state]) {
-                            next_set.insert(closure_state);
-                        }
-                    }
-                }
-                
-                if (!next_set.empty()) {
-                    if (state_map.find(next_set) == state_map.end()) {
-                        state_map[next_set] = ++dfa_state_count;
-                        DataStructures::dfa_states.push_back(DataStructures::DFAState());
-                    }
-                    
-                    DataStructures::dfa_states[state_map[current_set]].edges[symbol].push_back(state_map[next_set]);
-                    
-                    // 检查是否为接受状态
-                    for (const auto &state : next_set) {
-                        if (NFAManager::accept_states.find(state) != NFAManager::accept_states.end()) {
-                            DataStructures::dfa_states[state_map[next_set]].accept_state = true;
-                            break;
-                        }
-                    }
-                    
-                    if (!visited[next_set]) {
-                        queue.push(next_set);
-                    }
-                }
+
+        // 交的优先级介于选择和拼接之间：ab&a.|c 即 (ab&a.)|c
+        NodePtr parse_intersection() {
+            std::vector<NodePtr> operands = {parse_concatenation()};
+            while (extended && !at_end() && peek() == '&') {
+                pos++;
+                operands.push_back(parse_concatenation());
             }
+            return operands.size() == 1 ? operands[0] : make_node(NodeType::Intersect, std::move(operands));
         }
-        
-        // 检查初始状态是否为接受状态
-        for (const auto &state : initial_set) {
-            if (NFAManager::accept_states.find(state) != NFAManager::accept_states.end()) {
-                DataStructures::dfa_states[0].accept_state = true;
-                break;
+
+        NodePtr parse_concatenation() {
+            std::vector<NodePtr> items;
+            while (!at_end() && peek() != '|' && peek() != ')' && !(extended && peek() == '&')) {
+                items.push_back(parse_complement());
             }
+            if (items.empty()) return make_node(NodeType::Empty);
+            return items.size() == 1 ? items[0] : make_node(NodeType::Concat, std::move(items));
         }
-    }
-}
 
-// DFA管理模块
-namespace DFAManager {
-    int state_count = 0;
-    std::vector<int> states;
-    int initial_state = 0;
-    std::vector<int> accept_states;
-    std::vector<std::tuple<int, char, int>> transitions;
-    
-    void initialize() {
-        states.resize(DataStructures::dfa_states.size());
-        std::iota(states.begin(), states.end(), 0);
-        state_count = DataStructures::dfa_states.size();
+        // 前缀 '~' 作用于紧随其后的带量词的原子：~a* 即 ~(a*)
+        NodePtr parse_complement() {
+            if (!extended || peek() != '~') return parse_repetition();
+            pos++;
+            if (at_end() || peek() == '|' || peek() == ')' || peek() == '&') error("Missing operand for '~'");
+            return make_node(NodeType::Complement, {parse_complement()});
+        }
 
-        // 构建转移关系
-        for (int i = 0; i < state_count; i++) {
-            const auto &[edges, accept_state] = DataStructures::dfa_states[i];
-            for (auto index : Constants::CHARACTER_INDEX) {
-                if (!edges[index].empty()) {
-                    for (auto j : edges[index]) {
-                        transitions.push_back({i, (char)index, j});
-                    }
+        NodePtr parse_repetition() {
+            NodePtr atom = parse_atom();
+            while (!at_end()) {
+                unsigned char c = peek();
+                int min = 0, max = -1;
+                if (c == '{') {
+                    if (!parse_bounds(min, max)) break;
+                    atom = make_node(NodeType::Repeat, {atom});
+                    atom->min = min;
+                    atom->max = max;
+                    continue;
                 }
+                if (c == '*') atom = make_node(NodeType::Star, {atom});
+                else if (c == '+') atom = make_node(NodeType::Plus, {atom});
+                else if (c == '?') atom = make_node(NodeType::Optional, {atom});
+                else break;
+                pos++;
             }
+            return atom;
         }
 
-        // 找到接受状态
-        for (int i = 0; i < state_count; i++) {
-            if (DataStructures::dfa_states[i].accept_state) {
-                accept_states.push_back(i);
+        // 读取 {m}、{m,}、{m,n}；不是这三种形式时不移动位置并返回 false，'{' 按普通字符处理
+        bool parse_bounds(int &min, int &max) {
+            size_t p = pos + 1;
+            auto read_number = [&](int &value) {
+                size_t begin = p;
+                long long number = 0;
+                while (p < pattern.size() && std::isdigit((unsigned char)pattern[p])) {
+                    number = std::min<long long>(number * 10 + (pattern[p] - '0'), MAX_REPEAT + 1LL);
+                    p++;
+                }
+                value = number;
+                return p > begin;
+            };
+
+            if (!read_number(min)) return false;
+            max = min;
+            if (p < pattern.size() && pattern[p] == ',') {
+                p++;
+                if (!read_number(max)) max = -1;
             }
+            if (p >= pattern.size() || pattern[p] != '}') return false;
+
+            if (min > MAX_REPEAT || max > MAX_REPEAT) error("Repetition bound too large (max " + std::to_string(MAX_REPEAT) + ")");
+            if (max != -1 && min > max) error("Invalid repetition bounds");
+            pos = p + 1;
+            return true;
         }
-    }
-    
-    void print_dfa() {
-        std::cout << "\n=== DFA ===\n";
-        std::cout << "States: ";
-        for (const auto &i : states) {
-            std::cout << i << ' ';
-        }
-        std::cout << '\n';
 
-        std::cout << "Initial state: " << initial_state << '\n';
+        NodePtr parse_atom() {
+            unsigned char c = peek();
+            int min = 0, max = -1;
+            if (c == '*' || c == '+' || c == '?') error("Nothing to repeat");
+            if (c == '{' && parse_bounds(min, max)) error("Nothing to repeat");
 
-        std::cout << "Transitions: ";
-        for (const auto &[from, symbol, to] : transitions) {
-            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+            pos++;
+            if (c == '(' && pos + 1 < pattern.size() && peek() == '?' && pattern[pos + 1] == ':') {
+                pos += 2;
+                NodePtr inner = parse_alternation();
+                if (at_end() || peek() != ')') error("Missing ')'");
+                pos++;
+                return inner;
+            }
+            if (c == '(') {
+                if (!at_end() && peek() == '?') error("Unsupported group syntax");
+                int group = ++groups;
+                NodePtr inner = parse_alternation();
+                if (at_end() || peek() != ')') error("Missing ')'");
+                pos++;
+                NodePtr node = make_node(NodeType::Group, {inner});
+                node->group = group;
+                return node;
+            }
+            if (c == '[') return parse_class();
+            if (c == '.') return make_class(negate({{'\n', '\n'}}));
+            if (c == '\\') {
+                CodepointRanges ranges;
+                saw_unicode = false;
+                parse_escape(ranges);
+                return saw_unicode ? make_codepoint_class(ranges) : make_class(to_bytes(ranges));
+            }
+            uint32_t cp;
+            if (size_t length = decode_utf8(pos - 1, cp)) {
+                pos += length - 1;
+                return make_codepoint_class({{cp, cp}});
+            }
+            return make_class({{c, c}});
         }
-        std::cout << '\n';
 
-        std::cout << "Accept states: ";
-        for (const auto &i : accept_states) {
-            std::cout << i << ' ';
+        // 转义序列：\d \w \s 及其大写取反形式、\n \t \r \f \v \0、\xHH（字节）、\uHHHH 与 \u{H...}（码点），
+        // 其余非字母数字字符表示自身
+        void parse_escape(CodepointRanges &ranges) {
+            if (at_end()) error("Trailing '\\'");
+            unsigned char c = pattern[pos++];
+            CodepointRanges shorthand;
+            switch (c) {
+                case 'd': case 'D':
+                    shorthand = {{'0', '9'}};
+                    break;
+                case 'w': case 'W':
+                    shorthand = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+                    break;
+                case 's': case 'S':
+                    shorthand = {{'\t', '\r'}, {' ', ' '}};
+                    break;
+                case 'n': ranges.push_back({'\n', '\n'}); return;
+                case 't': ranges.push_back({'\t', '\t'}); return;
+                case 'r': ranges.push_back({'\r', '\r'}); return;
+                case 'f': ranges.push_back({'\f', '\f'}); return;
+                case 'v': ranges.push_back({'\v', '\v'}); return;
+                case '0': ranges.push_back({0, 0}); return;
+                case 'x': {
+                    uint32_t value = read_hex(2, "\\x");
+                    if (value >= 0x80) saw_raw = true;
+                    ranges.push_back({value, value});
+                    return;
+                }
+                case 'u': {
+                    uint32_t value = 0;
+                    if (!at_end() && peek() == '{') {
+                        pos++;
+                        size_t digits = 0;
+                        while (!at_end() && peek() != '}') {
+                            if (++digits > 6) error("Invalid \\u escape");
+                            value = value * 16 + read_hex(1, "\\u");
+                        }
+                        if (at_end() || digits == 0) error("Invalid \\u escape");
+                        pos++;
+                    } else {
+                        value = read_hex(4, "\\u");
+                    }
+                    if (value > MAX_CODEPOINT || (value >= 0xD800 && value <= 0xDFFF)) error("Invalid codepoint in \\u escape");
+                    if (value >= 0x80) saw_unicode = true;
+                    ranges.push_back({value, value});
+                    return;
+                }
+                default:
+                    if (std::isalnum(c)) error(std::string("Unknown escape '\\") + (char)c + "'");
+                    ranges.push_back({c, c});
+                    return;
+            }
+            if (std::isupper(c)) shorthand = negate_codepoints(shorthand);
+            ranges.insert(ranges.end(), shorthand.begin(), shorthand.end());
         }
-        std::cout << '\n';
-    }
-}
 
-// DFA最小化模块
-namespace DFAMinimizer {
-    std::vector<int> state_partition;
-    std::vector<std::set<int>> partitions;
-    std::set<std::tuple<int, char, int>> minimized_transitions;
-    
-    bool can_distinguish(const std::set<int> &partition, char symbol) {
-        if (partition.size() <= 1) return false;
-        
-        std::map<int, std::set<int>> destination_groups;
-        
-        for (auto state : partition) {
-            const auto &[edges, _] = DataStructures::dfa_states[state];
-            
-            int destination_partition = -1; // 表示没有转移
-            if (!edges[symbol].empty()) {
-                // 假设每个状态对每个符号只有一个转移
-                int next_state = edges[symbol][0];
-                destination_partition = state_partition[next_state];
+        // 字符类内的单个字节或码点；是 \d 之类的集合时返回 false
+        bool parse_class_item(CodepointRanges &ranges, uint32_t &value) {
+            if (peek() != '\\') {
+                if (size_t length = decode_utf8(pos, value)) {
+                    pos += length;
+                    saw_unicode = true;
+                    return true;
+                }
+                value = (unsigned char)pattern[pos++];
+                if (value >= 0x80) saw_raw = true;
+                return true;
             }
-            
-            destination_groups[destination_partition].insert(state);
+            pos++;
+            CodepointRanges item;
+            parse_escape(item);
+            if (item.size() == 1 && item[0].first == item[0].second) {
+                value = item[0].first;
+                return true;
+            }
+            ranges.insert(ranges.end(), item.begin(), item.end());
+            return false;
+        }
+
+        // 字符类：[abc]、[a-z0-9]、[^...]；紧跟 '[' 或 '[^' 的 ']' 以及首尾的 '-' 表示自身。
+        // 含有非ASCII字符（UTF-8 或 \u）时按码点解释，取反也在码点范围内进行，编译为UTF-8字节序列
+        NodePtr parse_class() {
+            bool negated = !at_end() && peek() == '^';
+            if (negated) pos++;
+
+            CodepointRanges ranges;
+            bool first = true;
+            saw_unicode = saw_raw = false;
+            while (true) {
+                if (at_end()) error("Unterminated character class");
+                if (peek() == ']' && !first) break;
+                first = false;
+
+                uint32_t lo;
+                if (!parse_class_item(ranges, lo)) continue;
+                if (pos + 1 < pattern.size() && peek() == '-' && pattern[pos + 1] != ']') {
+                    pos++;
+                    uint32_t hi;
+                    if (!parse_class_item(ranges, hi)) error("Invalid range in character class");
+                    if (lo > hi) error("Invalid range in character class");
+                    ranges.push_back({lo, hi});
+                } else {
+                    ranges.push_back({lo, lo});
+                }
+            }
+            if (saw_unicode && saw_raw) error("Raw bytes mixed with Unicode characters in character class");
+            pos++;
+            if (saw_unicode) return make_codepoint_class(negated ? negate_codepoints(ranges) : ranges);
+            ByteRanges bytes = to_bytes(ranges);
+            return make_class(negated ? negate(bytes) : bytes);
         }
+    };
+}
+
+// NFA构建模块（Thompson构造）：每个子表达式对应栈上的一对 (起点, 终点)
+namespace NFAConstructor {
+    void create_class_nfa(const RegexParser::ByteRanges &ranges) {
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
         
-        return destination_groups.size() > 1;
+        for (const auto &[lo, hi] : ranges) {
+            DataStructures::nfa.add_transition(start, lo, hi, end);
+        }
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
     }
     
-    std::vector<std::set<int>> split_partition(const std::set<int> &partition, char symbol) {
-        std::map<int, std::set<int>> destination_groups;
+    void create_empty_nfa() {
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
         
-        for (auto state : partition) {
-            const auto &[edges, _] = DataStructures::dfa_states[state];
-            
-            int destination_partition = -1;
-            if (!edges[symbol].empty()) {
-                int next_state = edges[symbol][0];
-                destination_partition = state_partition[next_state];
-            }
-            
-            destination_groups[destination_partition].insert(state);
+        DataStructures::nfa.add_epsilon(start, end);
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
+    }
+    
+    // 栈顶 count 个片段的多路选择，ε边按分支顺序加入（先写的分支优先）
+    void create_alternation_nfa(int count) {
+        std::vector<std::pair<int, int>> branches(count);
+        for (int i = count - 1; i >= 0; i--) {
+            branches[i].second = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+            branches[i].first = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
         }
-        
-        std::vector<std::set<int>> result;
-        for (auto &[_, group] : destination_groups) {
-            result.push_back(group);
+
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
+
+        for (const auto &[a, b] : branches) {
+            DataStructures::nfa.add_epsilon(start, a);
+            DataStructures::nfa.add_epsilon(b, end);
         }
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
+    }
+    
+    void create_concatenation_nfa() {
+        int d = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int c = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
         
-        return result;
+        DataStructures::nfa.add_epsilon(b, c);
+        DataStructures::state_stack.push(a);
+        DataStructures::state_stack.push(d);
     }
     
-    void minimize_dfa() {
-        state_partition.resize(DFAManager::state_count);
+    void create_kleene_star_nfa() {
+        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
         
-        // 初始分区：接受状态和非接受状态
-        std::set<int> accepting_states, non_accepting_states;
-        for (int i = 0; i < DFAManager::state_count; i++) {
-            if (DataStructures::dfa_states[i].accept_state) {
-                accepting_states.insert(i);
-                state_partition[i] = 1;
-            } else {
-                non_accepting_states.insert(i);
-                state_partition[i] = 0;
-            }
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
+        
+        DataStructures::nfa.add_epsilon(b, a);
+        DataStructures::nfa.add_epsilon(start, a);
+        DataStructures::nfa.add_epsilon(start, end);
+        DataStructures::nfa.add_epsilon(b, end);
+        
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
+    }
+    
+    // 新起点只进入一次，回环不经过它，外层捕获组的起点不会被每轮迭代改写
+    void create_plus_nfa() {
+        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
+        
+        DataStructures::nfa.add_epsilon(start, a);
+        DataStructures::nfa.add_epsilon(b, a);
+        DataStructures::nfa.add_epsilon(b, end);
+        
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
+    }
+    
+    void create_optional_nfa() {
+        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        
+        int start = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
+        
+        DataStructures::nfa.add_epsilon(start, a);
+        DataStructures::nfa.add_epsilon(start, end);
+        DataStructures::nfa.add_epsilon(b, end);
+        
+        DataStructures::state_stack.push(start);
+        DataStructures::state_stack.push(end);
+    }
+    
+    // 计数重复 x{m,n}：上界（无上界时为下界）不超过该值时展开，超过且 x 为单个字符类时用计数器
+    const int SMALL_REPEAT_LIMIT = 32;
+    // 展开重复时NFA状态数的上限
+    const int MAX_EXPANDED_STATES = 100000;
+    bool allow_counters = true;
+    
+    // 计数器片段：起点带区间自环（计数加一），起点到终点的ε转移受计数下界约束
+    void create_counter_nfa(const RegexParser::ByteRanges &ranges, int min, int max) {
+        int loop = DataStructures::nfa.add_state();
+        int end = DataStructures::nfa.add_state();
+        
+        for (const auto &[lo, hi] : ranges) {
+            DataStructures::nfa.add_transition(loop, lo, hi, loop);
         }
+        DataStructures::nfa.add_epsilon(loop, end);
+        DataStructures::nfa.add_counter(loop, min, max);
         
-        partitions.clear();
-        if (!non_accepting_states.empty()) partitions.push_back(non_accepting_states);
-        if (!accepting_states.empty()) partitions.push_back(accepting_states);
+        DataStructures::state_stack.push(loop);
+        DataStructures::state_stack.push(end);
+    }
+    
+    int capture_group_count = 0;
+    
+    // 把栈顶片段标记为第 group 个捕获组：进入片段起点记录组开始，进入片段终点记录组结束
+    void create_capture_group(int group) {
+        int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+        int a = DataStructures::state_stack.top();
+        DataStructures::state_stack.push(b);
         
-        bool changed = true;
-        while (changed) {
-            changed = false;
-            std::vector<std::set<int>> new_partitions;
-            
-            for (const auto &partition : partitions) {
-                bool partition_split = false;
-                
-                for (auto symbol : DataStructures::alphabet) {
-                    if (can_distinguish(partition, symbol)) {
-                        auto split_result = split_partition(partition, symbol);
-                        for (const auto &new_partition : split_result) {
-                            new_partitions.push_back(new_partition);
-                        }
-                        partition_split = true;
-                        changed = true;
-                        break;
-                    }
-                }
+        DataStructures::nfa.add_save(a, 2 * group);
+        DataStructures::nfa.add_save(b, 2 * group + 1);
+        capture_group_count = std::max(capture_group_count, group);
+    }
+    
+    void build_nfa_from_ast(const RegexParser::NodePtr &node);
+    
+    // 不实际构建，按上面各构造函数的规则计算子表达式生成的状态数和ε转移数
+    struct FragmentSize {
+        long long states = 0;
+        long long epsilons = 0;
+    };
+    
+    FragmentSize fragment_size(const RegexParser::NodePtr &node) {
+        using RegexParser::NodeType;
+        FragmentSize size;
+        auto add = [&size](const FragmentSize &other, long long times = 1) {
+            size.states += other.states * times;
+            size.epsilons += other.epsilons * times;
+        };
+        switch (node->type) {
+            case NodeType::Empty:
+                return {2, 1};
+            case NodeType::Class:
+                return {2, 0};
+            case NodeType::Concat:
+                for (const auto &child : node->children) add(fragment_size(child));
+                size.epsilons += node->children.size() - 1;
+                return size;
+            case NodeType::Alternate:
+                for (const auto &child : node->children) add(fragment_size(child));
+                size.states += 2;
+                size.epsilons += 2 * node->children.size();
+                return size;
+            case NodeType::Star:
+                add(fragment_size(node->children[0]));
+                add({2, 4});
+                return size;
+            case NodeType::Plus:
+            case NodeType::Optional:
+                add(fragment_size(node->children[0]));
+                add({2, 3});
+                return size;
+            case NodeType::Group:
+                return fragment_size(node->children[0]);
+            case NodeType::Repeat: {
+                const RegexParser::NodePtr &child = node->children[0];
+                int min = node->min, max = node->max;
+                int bound = max == -1 ? min : max;
+                if (allow_counters && child->type == NodeType::Class && bound > SMALL_REPEAT_LIMIT) return {2, 1};
+                if (min == 0 && max == 0) return {2, 1};
                 
-                if (!partition_split) {
-                    new_partitions.push_back(partition);
+                FragmentSize body = fragment_size(child);
+                add(body, min);
+                size.epsilons += std::max(min - 1, 0);
+                if (max == -1) {
+                    add(body);
+                    add({2, 4});
+                } else if (max > min) {
+                    long long optional = max - min;
+                    add(body, optional);
+                    size.states += optional + 1;
+                    size.epsilons += 3 * optional;
+                } else {
+                    return size;
                 }
+                if (min > 0) size.epsilons += 1;
+                return size;
             }
+            case NodeType::Intersect:
+            case NodeType::Complement:
+                break; // 没有对应的Thompson片段
+        }
+        return size;
+    }
+    
+    // 再构建一份子表达式；累计状态数超过 MAX_EXPANDED_STATES 时报错
+    void build_copy(const RegexParser::NodePtr &node) {
+        build_nfa_from_ast(node);
+        if (DataStructures::nfa.state_count > MAX_EXPANDED_STATES) {
+            throw std::runtime_error("Counted repetition too large to expand (more than " +
+                                     std::to_string(MAX_EXPANDED_STATES) + " NFA states)");
+        }
+    }
+    
+    // x{m,n} 展开为 m 个必选副本加上共享后缀的可选链 (x(x(x)?)?)?：
+    // 每个可选副本之前的状态都直接ε到同一个终点，状态数与 n 成线性
+    void create_repeat_nfa(const RegexParser::NodePtr &node) {
+        const RegexParser::NodePtr &child = node->children[0];
+        int min = node->min, max = node->max;
+        
+        int bound = max == -1 ? min : max;
+        if (allow_counters && child->type == RegexParser::NodeType::Class && bound > SMALL_REPEAT_LIMIT) {
+            create_counter_nfa(child->ranges, min, max);
+            return;
+        }
+        
+        if (min == 0 && max == 0) {
+            create_empty_nfa();
+            return;
+        }
+        
+        for (int i = 0; i < min; i++) {
+            build_copy(child);
+            if (i > 0) create_concatenation_nfa();
+        }
+        
+        if (max == -1) {
+            build_copy(child);
+            create_kleene_star_nfa();
+            if (min > 0) create_concatenation_nfa();
+            return;
+        }
+        
+        int optional = max - min;
+        if (optional == 0) return;
+        
+        int end = DataStructures::nfa.add_state();
+        int first = -1, previous_end = -1;
+        for (int i = 0; i < optional; i++) {
+            int entry = DataStructures::nfa.add_state();
+            build_copy(child);
+            int b = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
+            int a = DataStructures::state_stack.top(); DataStructures::state_stack.pop();
             
-            partitions = new_partitions;
-            
-            // 更新状态分区编号
-            for (int i = 0; i < partitions.size(); i++) {
-                for (auto state : partitions[i]) {
-                    state_partition[state] = i;
+            DataStructures::nfa.add_epsilon(entry, a);
+            DataStructures::nfa.add_epsilon(entry, end);
+            if (previous_end == -1) first = entry;
+            else DataStructures::nfa.add_epsilon(previous_end, entry);
+            previous_end = b;
+        }
+        DataStructures::nfa.add_epsilon(previous_end, end);
+        
+        DataStructures::state_stack.push(first);
+        DataStructures::state_stack.push(end);
+        if (min > 0) create_concatenation_nfa();
+    }
+    
+    void build_nfa_from_ast(const RegexParser::NodePtr &node) {
+        using RegexParser::NodeType;
+        switch (node->type) {
+            case NodeType::Empty:
+                create_empty_nfa();
+                break;
+            case NodeType::Class:
+                create_class_nfa(node->ranges);
+                break;
+            case NodeType::Concat:
+                build_nfa_from_ast(node->children[0]);
+                for (size_t i = 1; i < node->children.size(); i++) {
+                    build_nfa_from_ast(node->children[i]);
+                    create_concatenation_nfa();
                 }
+                break;
+            case NodeType::Alternate:
+                for (const auto &child : node->children) build_nfa_from_ast(child);
+                create_alternation_nfa(node->children.size());
+                break;
+            case NodeType::Star:
+                build_nfa_from_ast(node->children[0]);
+                create_kleene_star_nfa();
+                break;
+            case NodeType::Plus:
+                build_nfa_from_ast(node->children[0]);
+                create_plus_nfa();
+                break;
+            case NodeType::Optional:
+                build_nfa_from_ast(node->children[0]);
+                create_optional_nfa();
+                break;
+            case NodeType::Group:
+                build_nfa_from_ast(node->children[0]);
+                create_capture_group(node->group);
+                break;
+            case NodeType::Repeat:
+                create_repeat_nfa(node);
+                break;
+            case NodeType::Intersect:
+            case NodeType::Complement:
+                throw std::runtime_error("Intersection and complement require the derivative construction");
+        }
+    }
+}
+
+// 语法树优化模块：在Thompson构造之前改写语法树以减少NFA的状态和ε转移。
+// 改写不改变匹配的语言，也不改变捕获组的结果：含捕获组的子树不参与量词合并
+namespace RegexOptimizer {
+    using RegexParser::Node;
+    using RegexParser::NodePtr;
+    using RegexParser::NodeType;
+    using RegexParser::make_node;
+    
+    struct PassReport {
+        std::string name;
+        NFAConstructor::FragmentSize before;
+        NFAConstructor::FragmentSize after;
+    };
+    
+    std::vector<PassReport> last_report; // 最近一次优化中每一遍的NFA规模变化
+    
+    bool equal(const NodePtr &a, const NodePtr &b) {
+        if (a->type != b->type || a->ranges != b->ranges || a->group != b->group ||
+            a->min != b->min || a->max != b->max || a->children.size() != b->children.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a->children.size(); i++) {
+            if (!equal(a->children[i], b->children[i])) return false;
+        }
+        return true;
+    }
+    
+    bool has_groups(const NodePtr &node) {
+        if (node->type == NodeType::Group) return true;
+        for (const auto &child : node->children) {
+            if (has_groups(child)) return true;
+        }
+        return false;
+    }
+    
+    // 拼接：展开嵌套的拼接并去掉空串
+    NodePtr make_concat(const std::vector<NodePtr> &items) {
+        std::vector<NodePtr> flat;
+        for (const auto &item : items) {
+            if (item->type == NodeType::Concat) {
+                flat.insert(flat.end(), item->children.begin(), item->children.end());
+            } else if (item->type != NodeType::Empty) {
+                flat.push_back(item);
+            }
+        }
+        if (flat.empty()) return make_node(NodeType::Empty);
+        return flat.size() == 1 ? flat[0] : make_node(NodeType::Concat, std::move(flat));
+    }
+    
+    // 选择：展开嵌套的选择并去掉重复分支（保留先出现的，优先级不变）
+    NodePtr make_alternate(const std::vector<NodePtr> &branches) {
+        std::vector<NodePtr> flat;
+        for (const auto &branch : branches) {
+            std::vector<NodePtr> items = branch->type == NodeType::Alternate ? branch->children : std::vector<NodePtr>{branch};
+            for (const auto &item : items) {
+                bool duplicate = std::any_of(flat.begin(), flat.end(), [&](const NodePtr &seen) { return equal(seen, item); });
+                if (!duplicate) flat.push_back(item);
             }
         }
+        return flat.size() == 1 ? flat[0] : make_node(NodeType::Alternate, std::move(flat));
+    }
+    
+    // 第一遍：展开嵌套的拼接与选择，去掉空串和重复分支，如 (a|a) -> (a)
+    NodePtr flatten(const NodePtr &node) {
+        for (auto &child : node->children) child = flatten(child);
+        if (node->type == NodeType::Concat) return make_concat(node->children);
+        if (node->type == NodeType::Alternate) return make_alternate(node->children);
+        return node;
+    }
+    
+    bool is_quantifier(const NodePtr &node) {
+        return node->type == NodeType::Star || node->type == NodeType::Plus || node->type == NodeType::Optional;
+    }
+    
+    // 第二遍：合并量词。嵌套量词 (a*)* (a+)? 等折叠为一个，相邻的 a*a*、a*a+ 合并为 a*、a+
+    NodePtr collapse(const NodePtr &node) {
+        for (auto &child : node->children) child = collapse(child);
+        
+        if (is_quantifier(node) && is_quantifier(node->children[0]) && !has_groups(node)) {
+            const NodePtr &inner = node->children[0];
+            if (node->type == inner->type) return inner;
+            // 内外量词不同时：都是 + 才至少一次、都是 ? 才有上界，其余组合都等价于 *
+            return make_node(NodeType::Star, {inner->children[0]});
+        }
         
-        // 构建最小化后的转移关系
-        minimized_transitions.clear();
-        for (int i = 0; i < DFAManager::state_count; i++) {
-            const auto &[edges, _] = DataStructures::dfa_states[i];
-            for (const auto &index : Constants::CHARACTER_INDEX) {
-                if (!edges[index].empty()) {
-                    for (const auto &next_state : edges[index]) {
-                        minimized_transitions.insert({
-                            state_partition[i], 
-                            (char)index, 
-                            state_partition[next_state]
-                        });
-                    }
+        if (node->type == NodeType::Concat) {
+            std::vector<NodePtr> items;
+            for (const auto &child : node->children) {
+                if (!items.empty() && is_quantifier(items.back()) && is_quantifier(child) &&
+                    (items.back()->type == NodeType::Star || child->type == NodeType::Star) &&
+                    equal(items.back()->children[0], child->children[0]) && !has_groups(child)) {
+                    // x* 与 x*、x+、x? 相邻：至多一方至少一次，合并后无上界
+                    bool at_least_once = items.back()->type == NodeType::Plus || child->type == NodeType::Plus;
+                    items.back() = make_node(at_least_once ? NodeType::Plus : NodeType::Star, {child->children[0]});
+                    continue;
                 }
+                items.push_back(child);
             }
+            return make_concat(items);
         }
+        return node;
     }
     
-    void print_minimized_dfa() {
-        std::cout << "\n=== Minimized DFA ===\n";
-        std::cout << "Partitions: " << partitions.size() << "\n";
-        for (int i = 0; i < partitions.size(); i++) {
-            std::cout << "Partition " << i << ": {";
-            bool first = true;
-            for (auto state : partitions[i]) {
-                if (!first) std::cout << ", ";
-                std::cout << state;
-                first = false;
+    NodePtr first_item(const NodePtr &node) {
+        return node->type == NodeType::Concat ? node->children[0] : node;
+    }
+    
+    NodePtr rest_items(const NodePtr &node) {
+        if (node->type != NodeType::Concat) return make_node(NodeType::Empty);
+        return make_concat(std::vector<NodePtr>(node->children.begin() + 1, node->children.end()));
+    }
+    
+    // 第三遍：提取相邻分支的公共前缀，abc|abd -> ab(c|d)，递归进行后选择变成前缀树。
+    // 只合并相邻分支，分支的先后顺序不变
+    NodePtr factor(const NodePtr &node) {
+        for (auto &child : node->children) child = factor(child);
+        if (node->type != NodeType::Alternate) return node;
+        
+        const std::vector<NodePtr> &branches = node->children;
+        std::vector<NodePtr> factored;
+        for (size_t i = 0; i < branches.size();) {
+            NodePtr head = first_item(branches[i]);
+            size_t j = i + 1;
+            while (j < branches.size() && head->type != NodeType::Empty && equal(head, first_item(branches[j]))) j++;
+            if (j - i == 1) {
+                factored.push_back(branches[i]);
+            } else {
+                std::vector<NodePtr> rests;
+                for (size_t k = i; k < j; k++) rests.push_back(rest_items(branches[k]));
+                factored.push_back(make_concat({head, factor(make_alternate(rests))}));
             }
-            std::cout << "}\n";
+            i = j;
         }
+        return make_alternate(factored);
+    }
+    
+    // 第四遍：合并选择中相邻的单字符类分支，c|d -> [cd]
+    NodePtr merge_literals(const NodePtr &node) {
+        for (auto &child : node->children) child = merge_literals(child);
+        if (node->type != NodeType::Alternate) return node;
         
-        std::cout << "Minimized Transitions: ";
-        for (const auto& [from, symbol, to] : minimized_transitions) {
-            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+        std::vector<NodePtr> branches;
+        for (const auto &branch : node->children) {
+            if (!branches.empty() && branches.back()->type == NodeType::Class && branch->type == NodeType::Class) {
+                RegexParser::ByteRanges ranges = branches.back()->ranges;
+                ranges.insert(ranges.end(), branch->ranges.begin(), branch->ranges.end());
+                branches.back() = RegexParser::make_class(ranges);
+                continue;
+            }
+            branches.push_back(branch);
         }
-        std::cout << "\n";
+        return branches.size() == 1 ? branches[0] : make_node(NodeType::Alternate, std::move(branches));
     }
     
-    void export_to_dot(const std::string &filename) {
-        std::ofstream out(filename);
-        out << "digraph DFA {\n";
-        out << "  rankdir=LR;\n";
+    NodePtr optimize(NodePtr root) {
+        static const std::vector<std::pair<std::string, NodePtr (*)(const NodePtr &)>> passes = {
+            {"flatten", flatten},
+            {"collapse", collapse},
+            {"factor", factor},
+            {"merge-literals", merge_literals},
+        };
+        
+        last_report.clear();
+        for (const auto &[name, pass] : passes) {
+            NFAConstructor::FragmentSize before = NFAConstructor::fragment_size(root);
+            root = pass(root);
+            last_report.push_back({name, before, NFAConstructor::fragment_size(root)});
+        }
+        return root;
+    }
+}
 
-        // 确定接受状态
-        std::set<int> accept_partitions;
-        for (const auto &state : DFAManager::accept_states) {
-            accept_partitions.insert(state_partition[state]);
+// Glushkov构造（位置自动机）：每个字符类叶子是一个位置，状态 0 为初始状态，状态 p+1 对应位置 p，
+// 进入某状态的所有转移都标记该位置的字符类。得到的NFA没有ε转移，m 个位置恰好 m+1 个状态
+namespace GlushkovConstructor {
+    // 位置数与转移数的上限；计数重复按位置展开，不使用计数器
+    const int MAX_POSITIONS = 10000;
+    const long long MAX_TRANSITIONS = 1000000;
+    
+    struct Info {
+        bool nullable = true;
+        std::vector<int> first; // 可以作为第一个字符的位置
+        std::vector<int> last;  // 可以作为最后一个字符的位置
+    };
+    
+    std::vector<RegexParser::ByteRanges> position_ranges;
+    std::vector<std::vector<int>> follow; // follow[p]：位置 p 之后可以紧跟的位置
+    long long follow_count = 0;
+    int position_limit = MAX_POSITIONS;
+    
+    void link(const std::vector<int> &from, const std::vector<int> &to) {
+        for (int p : from) {
+            follow[p].insert(follow[p].end(), to.begin(), to.end());
+        }
+        follow_count += (long long)from.size() * to.size();
+        if (follow_count > MAX_TRANSITIONS) {
+            throw std::runtime_error("Glushkov automaton too large (more than " + std::to_string(MAX_TRANSITIONS) + " transitions)");
+        }
+    }
+    
+    Info concat(Info a, const Info &b) {
+        link(a.last, b.first);
+        if (a.nullable) a.first.insert(a.first.end(), b.first.begin(), b.first.end());
+        if (b.nullable) a.last.insert(a.last.end(), b.last.begin(), b.last.end());
+        else a.last = b.last;
+        a.nullable = a.nullable && b.nullable;
+        return a;
+    }
+    
+    Info star(Info a) {
+        link(a.last, a.first);
+        a.nullable = true;
+        return a;
+    }
+    
+    Info analyze(const RegexParser::NodePtr &node) {
+        using RegexParser::NodeType;
+        Info info;
+        switch (node->type) {
+            case NodeType::Empty:
+                return info;
+            case NodeType::Class: {
+                if (position_ranges.size() >= position_limit) {
+                    throw std::runtime_error("Glushkov automaton too large (more than " + std::to_string(position_limit) + " positions)");
+                }
+                int position = position_ranges.size();
+                position_ranges.push_back(node->ranges);
+                follow.emplace_back();
+                info.nullable = false;
+                info.first = info.last = {position};
+                return info;
+            }
+            case NodeType::Concat:
+                for (const auto &child : node->children) info = concat(std::move(info), analyze(child));
+                return info;
+            case NodeType::Alternate:
+                info.nullable = false;
+                for (const auto &child : node->children) {
+                    Info branch = analyze(child);
+                    info.nullable = info.nullable || branch.nullable;
+                    info.first.insert(info.first.end(), branch.first.begin(), branch.first.end());
+                    info.last.insert(info.last.end(), branch.last.begin(), branch.last.end());
+                }
+                return info;
+            case NodeType::Star:
+                return star(analyze(node->children[0]));
+            case NodeType::Plus: {
+                Info body = analyze(node->children[0]);
+                bool nullable = body.nullable;
+                body = star(std::move(body));
+                body.nullable = nullable;
+                return body;
+            }
+            case NodeType::Optional:
+                info = analyze(node->children[0]);
+                info.nullable = true;
+                return info;
+            case NodeType::Group:
+                return analyze(node->children[0]);
+            case NodeType::Repeat: {
+                const RegexParser::NodePtr &child = node->children[0];
+                for (int i = 0; i < node->min; i++) info = concat(std::move(info), analyze(child));
+                if (node->max == -1) return concat(std::move(info), star(analyze(child)));
+                
+                // 可选部分按 (x(x(x)?)?)? 从内向外构造，follow 边与副本数成线性
+                Info optional;
+                for (int i = node->max - node->min; i > 0; i--) {
+                    optional = concat(analyze(child), optional);
+                    optional.nullable = true;
+                }
+                return concat(std::move(info), optional);
+            }
+            case NodeType::Intersect:
+            case NodeType::Complement:
+                throw std::runtime_error("Intersection and complement require the derivative construction");
         }
+        return info;
+    }
+    
+    void reset() {
+        position_ranges.clear();
+        follow.clear();
+        follow_count = 0;
+    }
+    
+    // 计算整棵树的位置信息，position_ranges 与 follow 留给调用者使用；位置超过 limit 个时抛出异常
+    Info collect(const RegexParser::NodePtr &root, int limit) {
+        reset();
+        position_limit = limit;
+        return analyze(root);
+    }
+    
+    // 从语法树构建位置自动机到 automaton（不调用 finalize），返回初始状态
+    int build(const RegexParser::NodePtr &root, DataStructures::CompactAutomaton &automaton) {
+        Info info = collect(root, MAX_POSITIONS);
         
-        // 输出非接受状态
-        out << "  node [shape = circle];\n";
-        for (int i = 0; i < partitions.size(); ++i) {
-            if (accept_partitions.find(i) == accept_partitions.end()) {
-                out << "  " << i << ";\n";
+        int start_state = automaton.add_state();
+        for (size_t p = 0; p < position_ranges.size(); p++) automaton.add_state();
+        
+        auto add_edges = [&](int from, std::vector<int> &targets) {
+            std::sort(targets.begin(), targets.end());
+            targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+            for (int q : targets) {
+                for (const auto &[lo, hi] : position_ranges[q]) {
+                    automaton.add_transition(from, lo, hi, start_state + 1 + q);
+                }
             }
+        };
+        add_edges(start_state, info.first);
+        for (size_t p = 0; p < follow.size(); p++) add_edges(start_state + 1 + p, follow[p]);
+        
+        if (info.nullable) automaton.accept_states[start_state] = 1;
+        for (int p : info.last) automaton.accept_states[start_state + 1 + p] = 1;
+        
+        reset();
+        return start_state;
+    }
+}
+
+// 位并行匹配模块：位置不超过64个时，Glushkov自动机的活动位置集合就是一个64位字 D，
+// 每读入一个字节 D' = Follow(D) & B[byte]，不需要NFA模拟或子集构造。
+// Follow(D) 按每8个位置一张256项的表查出后按位或；位置只会跟到自身或下一个位置时（如 ab+c）
+// 直接用 Shift-And：Follow(D) = (D << 1) | (D & 自环位置)
+namespace BitParallel {
+    const int MAX_POSITIONS = 64;
+    
+    struct Matcher {
+        bool ready = false;
+        bool nullable = false;
+        bool shift_and = false;
+        int positions = 0;
+        uint64_t first = 0;
+        uint64_t last = 0;
+        uint64_t self_loops = 0;
+        std::array<uint64_t, 256> byte_masks{};             // B[byte]：字符类包含该字节的位置
+        std::vector<std::array<uint64_t, 256>> follow_tables; // 第 k 张表：位置 8k..8k+7 的子集 -> follow 的并集
+    };
+    
+    Matcher compiled;
+    
+    // 位置超过 MAX_POSITIONS 个时返回 false，compiled 保持未就绪
+    bool compile(const RegexParser::NodePtr &root) {
+        compiled = Matcher();
+        GlushkovConstructor::Info info;
+        try {
+            info = GlushkovConstructor::collect(root, MAX_POSITIONS);
+        } catch (const std::runtime_error &) {
+            GlushkovConstructor::reset();
+            return false;
         }
         
-        // 输出接受状态
-        if (!accept_partitions.empty()) {
-            out << "  node [shape = doublecircle];\n";
-            for (int state : accept_partitions) {
-                out << "  " << state << ";\n";
+        Matcher &m = compiled;
+        m.positions = GlushkovConstructor::position_ranges.size();
+        m.nullable = info.nullable;
+        for (int p : info.first) m.first |= 1ULL << p;
+        for (int p : info.last) m.last |= 1ULL << p;
+        
+        std::vector<uint64_t> follow_masks(m.positions, 0);
+        m.shift_and = m.positions == 0 || m.first == 1;
+        for (int p = 0; p < m.positions; p++) {
+            for (const auto &[lo, hi] : GlushkovConstructor::position_ranges[p]) {
+                for (int byte = lo; byte <= hi; byte++) m.byte_masks[byte] |= 1ULL << p;
             }
+            for (int q : GlushkovConstructor::follow[p]) follow_masks[p] |= 1ULL << q;
+            if (follow_masks[p] & (1ULL << p)) m.self_loops |= 1ULL << p;
+            
+            uint64_t next = p + 1 < m.positions ? 1ULL << (p + 1) : 0;
+            if ((follow_masks[p] & ~(1ULL << p)) != next) m.shift_and = false;
         }
+        GlushkovConstructor::reset();
         
-        // 初始状态箭头
-        int initial_partition = state_partition[0];
-        out << "  __start [shape=point];\n";
-        out << "  __start -> " << initial_partition << ";\n";
+        if (!m.shift_and) {
+            m.follow_tables.assign((m.positions + 7) / 8, {});
+            for (size_t k = 0; k < m.follow_tables.size(); k++) {
+                auto &table = m.follow_tables[k];
+                for (int subset = 1; subset < 256; subset++) {
+                    int bit = 0;
+                    while (!(subset & (1 << bit))) bit++;
+                    int p = 8 * k + bit;
+                    table[subset] = table[subset & (subset - 1)] | (p < m.positions ? follow_masks[p] : 0);
+                }
+            }
+        }
+        m.ready = true;
+        return true;
+    }
+    
+    bool match(const Matcher &m, const std::string &input) {
+        if (input.empty()) return m.nullable;
         
-        // 输出转移关系
-        for (const auto &[src, symbol, dest] : minimized_transitions) {
-            out << "  " << src << " -> " << dest << " [label=\"" << symbol << "\"];\n";
+        uint64_t active = m.first & m.byte_masks[(unsigned char)input[0]];
+        for (size_t i = 1; i < input.size() && active; i++) {
+            uint64_t next;
+            if (m.shift_and) {
+                next = (active << 1) | (active & m.self_loops);
+            } else {
+                next = 0;
+                for (size_t k = 0; k < m.follow_tables.size(); k++) {
+                    next |= m.follow_tables[k][(active >> (8 * k)) & 0xFF];
+                }
+            }
+            active = next & m.byte_masks[(unsigned char)input[i]];
+        }
+        return (active & m.last) != 0;
+    }
+}
+
+// 导数构造模块（Brzozowski）：不经过NFA，DFA状态就是正则表达式项，状态 r 读入字节 c 后到达 r 的导数 d_c(r)。
+// 项在构造时规范化（选择与交按编号排序去重、拼接右结合、字符类合并、∅ 与 ε 化简）并散列共享，
+// 相似的项得到同一编号，因此导数只有有限多个。交与补直接作用在项上
+namespace DerivativeDFA {
+    enum class Kind { Nothing, Epsilon, Class, Concat, Star, Or, And, Not };
+    using ByteSet = std::array<uint64_t, 4>;
+    
+    struct Term {
+        Kind kind;
+        ByteSet bytes{};          // Class：字节集合
+        std::vector<int> children; // Concat 为 (左, 右)，Or/And 按编号升序
+        bool nullable = false;
+    };
+    
+    // 计数重复逐份展开，上界过大时项的嵌套过深
+    const int MAX_REPEAT = 1000;
+    
+    std::vector<Term> terms;
+    std::map<std::tuple<int, ByteSet, std::vector<int>>, int> interned;
+    std::unordered_map<long long, int> derivatives; // 项 * 256 + 字节 -> 导数，子项在不同状态间共享
+    int NOTHING = 0, EPSILON = 1, ANYTHING = 2; // ∅、ε、~∅（任意字节串）
+    
+    bool contains(const ByteSet &set, unsigned char byte) {
+        return (set[byte >> 6] >> (byte & 63)) & 1;
+    }
+    
+    bool is_empty(const ByteSet &set) {
+        return !(set[0] | set[1] | set[2] | set[3]);
+    }
+    
+    int intern(Kind kind, const ByteSet &bytes, std::vector<int> children) {
+        auto key = std::make_tuple((int)kind, bytes, children);
+        auto it = interned.find(key);
+        if (it != interned.end()) return it->second;
+        
+        Term term{kind, bytes, std::move(children)};
+        switch (kind) {
+            case Kind::Nothing: case Kind::Class: term.nullable = false; break;
+            case Kind::Epsilon: case Kind::Star: term.nullable = true; break;
+            case Kind::Concat: case Kind::And:
+                term.nullable = std::all_of(term.children.begin(), term.children.end(), [](int c) { return terms[c].nullable; });
+                break;
+            case Kind::Or:
+                term.nullable = std::any_of(term.children.begin(), term.children.end(), [](int c) { return terms[c].nullable; });
+                break;
+            case Kind::Not:
+                term.nullable = !terms[term.children[0]].nullable;
+                break;
+        }
+        int id = terms.size();
+        terms.push_back(std::move(term));
+        interned.emplace(std::move(key), id);
+        return id;
+    }
+    
+    void reset() {
+        terms.clear();
+        interned.clear();
+        derivatives.clear();
+        NOTHING = intern(Kind::Nothing, {}, {});
+        EPSILON = intern(Kind::Epsilon, {}, {});
+        ANYTHING = intern(Kind::Not, {}, {NOTHING});
+    }
+    
+    int make_class(const ByteSet &bytes) {
+        return is_empty(bytes) ? NOTHING : intern(Kind::Class, bytes, {});
+    }
+    
+    int make_concat(int a, int b) {
+        if (a == NOTHING || b == NOTHING) return NOTHING;
+        if (a == EPSILON) return b;
+        if (b == EPSILON) return a;
+        if (terms[a].kind == Kind::Concat) {
+            int left = terms[a].children[0], right = terms[a].children[1];
+            return make_concat(left, make_concat(right, b));
+        }
+        return intern(Kind::Concat, {}, {a, b});
+    }
+    
+    int make_star(int a) {
+        if (a == NOTHING || a == EPSILON) return EPSILON;
+        if (terms[a].kind == Kind::Star) return a;
+        return intern(Kind::Star, {}, {a});
+    }
+    
+    int make_not(int a) {
+        if (terms[a].kind == Kind::Not) return terms[a].children[0];
+        return intern(Kind::Not, {}, {a});
+    }
+    
+    // 选择（union 为 true）或交：展开同类嵌套，字符类合并为一个，排序去重
+    int make_set(Kind kind, const std::vector<int> &items) {
+        bool is_union = kind == Kind::Or;
+        int absorbing = is_union ? ANYTHING : NOTHING; // 出现即决定结果
+        int neutral = is_union ? NOTHING : ANYTHING;   // 可以直接去掉
+        
+        std::vector<int> flat;
+        for (int item : items) {
+            if (terms[item].kind == kind) flat.insert(flat.end(), terms[item].children.begin(), terms[item].children.end());
+            else flat.push_back(item);
+        }
+        
+        std::vector<int> result;
+        bool has_class = false;
+        ByteSet merged{};
+        for (int item : flat) {
+            if (item == absorbing) return absorbing;
+            if (item == neutral) continue;
+            if (terms[item].kind != Kind::Class) {
+                result.push_back(item);
+                continue;
+            }
+            for (int w = 0; w < 4; w++) {
+                merged[w] = !has_class ? terms[item].bytes[w]
+                          : is_union ? merged[w] | terms[item].bytes[w] : merged[w] & terms[item].bytes[w];
+            }
+            has_class = true;
+        }
+        if (has_class) {
+            int cls = make_class(merged);
+            if (cls == absorbing) return absorbing;
+            if (cls != neutral) result.push_back(cls);
+        }
+        
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        if (result.empty()) return neutral;
+        if (result.size() == 1) return result[0];
+        return intern(kind, {}, std::move(result));
+    }
+    
+    int compute_derivative(int t, unsigned char byte);
+    
+    int derivative(int t, unsigned char byte) {
+        long long key = (long long)t * 256 + byte;
+        auto it = derivatives.find(key);
+        if (it != derivatives.end()) return it->second;
+        int result = compute_derivative(t, byte);
+        derivatives[key] = result;
+        return result;
+    }
+    
+    int compute_derivative(int t, unsigned char byte) {
+        const Term &term = terms[t];
+        switch (term.kind) {
+            case Kind::Nothing:
+            case Kind::Epsilon:
+                return NOTHING;
+            case Kind::Class:
+                return contains(term.bytes, byte) ? EPSILON : NOTHING;
+            case Kind::Concat: {
+                int left = term.children[0], right = term.children[1];
+                int first = make_concat(derivative(left, byte), right);
+                if (!terms[left].nullable) return first;
+                return make_set(Kind::Or, {first, derivative(right, byte)});
+            }
+            case Kind::Star:
+                return make_concat(derivative(term.children[0], byte), t);
+            case Kind::Or:
+            case Kind::And: {
+                std::vector<int> parts;
+                for (int child : std::vector<int>(term.children)) parts.push_back(derivative(child, byte));
+                return make_set(terms[t].kind, parts);
+            }
+            case Kind::Not:
+                return make_not(derivative(term.children[0], byte));
+        }
+        return NOTHING;
+    }
+    
+    int from_ast(const RegexParser::NodePtr &node) {
+        using RegexParser::NodeType;
+        switch (node->type) {
+            case NodeType::Empty:
+                return EPSILON;
+            case NodeType::Class: {
+                ByteSet bytes{};
+                for (const auto &[lo, hi] : node->ranges) {
+                    for (int byte = lo; byte <= hi; byte++) bytes[byte >> 6] |= 1ULL << (byte & 63);
+                }
+                return make_class(bytes);
+            }
+            case NodeType::Concat: {
+                int result = EPSILON;
+                for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) {
+                    result = make_concat(from_ast(*it), result);
+                }
+                return result;
+            }
+            case NodeType::Alternate:
+            case NodeType::Intersect: {
+                std::vector<int> parts;
+                for (const auto &child : node->children) parts.push_back(from_ast(child));
+                return make_set(node->type == NodeType::Alternate ? Kind::Or : Kind::And, parts);
+            }
+            case NodeType::Star:
+                return make_star(from_ast(node->children[0]));
+            case NodeType::Plus: {
+                int body = from_ast(node->children[0]);
+                return make_concat(body, make_star(body));
+            }
+            case NodeType::Optional:
+                return make_set(Kind::Or, {from_ast(node->children[0]), EPSILON});
+            case NodeType::Group:
+                return from_ast(node->children[0]);
+            case NodeType::Repeat: {
+                int bound = node->max == -1 ? node->min : node->max;
+                if (bound > MAX_REPEAT) {
+                    throw std::runtime_error("Repetition bound too large for the derivative construction (max " +
+                                             std::to_string(MAX_REPEAT) + ")");
+                }
+                int body = from_ast(node->children[0]);
+                int result = node->max == -1 ? make_star(body) : EPSILON;
+                for (int i = node->min; i < node->max; i++) {
+                    result = make_set(Kind::Or, {make_concat(body, result), EPSILON});
+                }
+                for (int i = 0; i < node->min; i++) result = make_concat(body, result);
+                return result;
+            }
+            case NodeType::Complement:
+                return make_not(from_ast(node->children[0]));
+        }
+        return NOTHING;
+    }
+    
+    // 语法树中所有字符类的区间端点把 0-255 切成若干段，同一段内的字节对任何导数都等价
+    void collect_boundaries(const RegexParser::NodePtr &node, std::vector<char> &starts) {
+        for (const auto &[lo, hi] : node->ranges) {
+            starts[lo] = 1;
+            starts[hi + 1] = 1;
+        }
+        for (const auto &child : node->children) collect_boundaries(child, starts);
+    }
+    
+    int explored_terms = 0; // 最近一次构造中的项数（含中间项）
+    
+    // 是否用到交或补（只有导数构造支持）
+    bool uses_boolean_operators(const RegexParser::NodePtr &node) {
+        if (node->type == RegexParser::NodeType::Intersect || node->type == RegexParser::NodeType::Complement) return true;
+        for (const auto &child : node->children) {
+            if (uses_boolean_operators(child)) return true;
+        }
+        return false;
+    }
+    
+    // 从语法树直接构造DFA到 DataStructures::dfa（状态 0 为初始状态）；
+    // 导数为 ∅ 的转移不建立。状态数 × 字节段数超过 max_transitions 时抛出异常
+    void build(const RegexParser::NodePtr &root, size_t max_transitions) {
+        reset();
+        DataStructures::CompactAutomaton &dfa = DataStructures::dfa;
+        dfa.clear();
+        
+        std::vector<char> starts(257, 0);
+        starts[0] = 1;
+        collect_boundaries(root, starts);
+        std::vector<std::pair<int, int>> segments;
+        for (int byte = 0; byte < 256; byte++) {
+            if (starts[byte]) segments.push_back({byte, byte});
+            else segments.back().second = byte;
+        }
+        
+        size_t max_states = std::max<size_t>(1, max_transitions / segments.size());
+        std::unordered_map<int, int> state_of; // 项 -> DFA状态
+        std::vector<int> worklist = {from_ast(root)};
+        state_of[worklist[0]] = dfa.add_state();
+        
+        for (size_t id = 0; id < worklist.size(); id++) {
+            int term = worklist[id];
+            dfa.accept_states[id] = terms[term].nullable;
+            
+            int range_lo = -1, range_hi = -1, range_target = -1;
+            for (const auto &[lo, hi] : segments) {
+                int next = derivative(term, lo);
+                if (next == NOTHING) continue;
+                
+                auto it = state_of.find(next);
+                if (it == state_of.end()) {
+                    if (worklist.size() >= max_states) {
+                        throw std::runtime_error("Derivative DFA too large (more than " + std::to_string(max_states) + " states)");
+                    }
+                    it = state_of.emplace(next, dfa.add_state()).first;
+                    worklist.push_back(next);
+                }
+                if (it->second == range_target && lo == range_hi + 1) {
+                    range_hi = hi;
+                    continue;
+                }
+                if (range_target != -1) dfa.add_transition(id, range_lo, range_hi, range_target);
+                range_lo = lo;
+                range_hi = hi;
+                range_target = it->second;
+            }
+            if (range_target != -1) dfa.add_transition(id, range_lo, range_hi, range_target);
+        }
+        
+        explored_terms = terms.size();
+        std::cout << "Derivative construction: " << explored_terms << " terms -> " << dfa.state_count << " DFA states\n";
+        dfa.finalize();
+        reset();
+    }
+}
+
+// NFA管理模块
+namespace NFAManager {
+    std::vector<int> states;
+    std::set<int> non_initial_states;
+    int initial_state;
+    std::set<int> accept_states;
+    std::vector<std::tuple<int, std::string, int>> transitions; // (起点, 标签, 终点)，ε转移的标签为 EPSILON_LABEL
+    
+    void initialize(int start_state) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        states.resize(nfa.state_count);
+        std::iota(states.begin(), states.end(), 0);
+
+        for (int i = 0; i < nfa.state_count; i++) {
+            // 处理区间转移
+            for (int k = nfa.transition_offsets[i]; k < nfa.transition_offsets[i + 1]; k++) {
+                transitions.push_back({i, DataStructures::range_label(nfa.transition_lo[k], nfa.transition_hi[k]),
+                                       nfa.transition_targets[k]});
+                non_initial_states.insert(nfa.transition_targets[k]);
+            }
+            
+            // 处理epsilon转移
+            for (int k = nfa.epsilon_offsets[i]; k < nfa.epsilon_offsets[i + 1]; k++) {
+                transitions.push_back({i, DataStructures::EPSILON_LABEL, nfa.epsilon_targets[k]});
+                non_initial_states.insert(nfa.epsilon_targets[k]);
+            }
+        }
+
+        initial_state = start_state;
+
+        // 找到接受状态
+        for (int i = 0; i < nfa.state_count; i++) {
+            if (nfa.accept_states[i]) {
+                accept_states.insert(i);
+            }
+        }
+    }
+    
+    void print_nfa() {
+        std::cout << "=== NFA ===\n";
+        std::cout << "States: ";
+        for (const auto &i : states) {
+            std::cout << i << ' ';
+        }
+        std::cout << '\n';
+
+        std::cout << "Alphabet: ";
+        DataStructures::ByteClasses classes(DataStructures::nfa);
+        for (int c = 0; c < classes.count(); c++) {
+            if (classes.covered[c]) std::cout << DataStructures::range_label(classes.ranges[c].first, classes.ranges[c].second) << ' ';
+        }
+        std::cout << '\n';
+
+        std::cout << "Initial state: " << initial_state << '\n';
+
+        std::cout << "Transitions: ";
+        for (const auto &[from, symbol, to] : transitions) {
+            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+        }
+        std::cout << '\n';
+
+        std::cout << "Accept states: ";
+        for (const auto &i : accept_states) {
+            std::cout << i << ' ';
+        }
+        std::cout << '\n';
+    }
+}
+
+// DFA转换模块
+namespace DFAConverter {
+    // 稀疏集合：O(1) 插入/查询/清空，成员按插入顺序存放在 dense 中
+    struct SparseSet {
+        std::vector<int> dense;
+        std::vector<int> sparse;
+
+        explicit SparseSet(int capacity) : sparse(capacity, 0) {
+            dense.reserve(capacity);
+        }
+
+        bool contains(int value) const {
+            int index = sparse[value];
+            return index < dense.size() && dense[index] == value;
+        }
+
+        void insert(int value) {
+            if (contains(value)) return;
+            sparse[value] = dense.size();
+            dense.push_back(value);
+        }
+
+        void clear() {
+            dense.clear();
+        }
+    };
+
+    // 有序状态向量的哈希，用作DFA状态的键
+    struct StateSetHash {
+        size_t operator()(const std::vector<int> &states) const {
+            size_t hash = 1469598103934665603ULL;
+            for (int state : states) {
+                hash ^= static_cast<size_t>(state);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+    };
+
+    // 迭代计算ε闭包：把 set 就地扩展为其ε闭包，stack 为复用的工作栈
+    void compute_epsilon_closure(SparseSet &set, std::vector<int> &stack) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        stack.assign(set.dense.begin(), set.dense.end());
+        while (!stack.empty()) {
+            int state = stack.back();
+            stack.pop_back();
+            for (int k = nfa.epsilon_offsets[state]; k < nfa.epsilon_offsets[state + 1]; k++) {
+                int next_state = nfa.epsilon_targets[k];
+                if (!set.contains(next_state)) {
+                    set.insert(next_state);
+                    stack.push_back(next_state);
+                }
+            }
+        }
+    }
+    
+    // 完整DFA的规模上限按稠密表的转移数计（状态数 × 字节类数，每项 4 字节），默认 4M 项即 16MB；
+    // 超过后放弃完整构建，改用惰性DFA匹配。可通过 RegexAutomata::setDFATransitionLimit 调整
+    const size_t DEFAULT_MAX_DFA_TRANSITIONS = size_t(1) << 22;
+    size_t max_dfa_transitions = DEFAULT_MAX_DFA_TRANSITIONS;
+
+    // 给定字节类数时允许的DFA状态数
+    size_t state_limit(int class_count) {
+        return std::max<size_t>(1, max_dfa_transitions / std::max(1, class_count));
+    }
+
+    // 子集构造；状态数 × 字节类数超过 max_dfa_transitions 时清空DFA并返回 false
+    bool convert_nfa_to_dfa(int start_state, int nfa_size) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        DataStructures::CompactAutomaton &dfa = DataStructures::dfa;
+        dfa.clear();
+
+        // DFA状态 i 对应的NFA状态集合（有序），下标即为工作表：按编号顺序逐个处理
+        std::vector<std::vector<int>> dfa_sets;
+        std::unordered_map<std::vector<int>, int, StateSetHash> state_map;
+
+        SparseSet current(nfa_size);
+        std::vector<int> stack;
+
+        // 登记一个新的状态集合（current 须已是ε闭包），返回DFA状态编号
+        auto intern = [&](SparseSet &set) {
+            std::vector<int> key = set.dense;
+            std::sort(key.begin(), key.end());
+            auto it = state_map.find(key);
+            if (it != state_map.end()) return it->second;
+
+            int id = dfa.add_state();
+            for (int state : key) {
+                if (nfa.accept_states[state]) {
+                    dfa.accept_states[id] = 1;
+                    break;
+                }
+            }
+            state_map.emplace(key, id);
+            dfa_sets.push_back(std::move(key));
+            return id;
+        };
+
+        current.insert(start_state);
+        compute_epsilon_closure(current, stack);
+        intern(current);
+
+        // 按字节类分桶：一次扫描集合中所有状态的转移，每条区间转移落入它覆盖的各个字节类
+        DataStructures::ByteClasses classes(nfa);
+        std::vector<std::vector<int>> moves(classes.count());
+        std::vector<int> touched_classes;
+        const size_t max_states = state_limit(classes.count());
+
+        for (int id = 0; id < dfa_sets.size(); id++) {
+            if (dfa_sets.size() > max_states) {
+                std::cout << "Subset construction aborted: more than " << max_states << " DFA states ("
+                          << classes.count() << " byte classes)\n";
+                dfa.clear();
+                return false;
+            }
+
+            touched_classes.clear();
+            for (int state : dfa_sets[id]) {
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    int last = classes.class_of[nfa.transition_hi[k]];
+                    for (int c = classes.class_of[nfa.transition_lo[k]]; c <= last; c++) {
+                        if (moves[c].empty()) touched_classes.push_back(c);
+                        moves[c].push_back(nfa.transition_targets[k]);
+                    }
+                }
+            }
+            std::sort(touched_classes.begin(), touched_classes.end());
+
+            // 相邻字节类到达同一状态时合并为一个区间
+            int range_lo = -1, range_hi = -1, range_target = -1;
+            for (int c : touched_classes) {
+                current.clear();
+                for (int target : moves[c]) current.insert(target);
+                moves[c].clear();
+
+                compute_epsilon_closure(current, stack);
+                int next_id = intern(current);
+                if (next_id == range_target && classes.ranges[c].first == range_hi + 1) {
+                    range_hi = classes.ranges[c].second;
+                    continue;
+                }
+                if (range_target != -1) dfa.add_transition(id, range_lo, range_hi, range_target);
+                range_lo = classes.ranges[c].first;
+                range_hi = classes.ranges[c].second;
+                range_target = next_id;
+            }
+            if (range_target != -1) dfa.add_transition(id, range_lo, range_hi, range_target);
+        }
+
+        std::cout << "Subset construction: " << nfa_size << " NFA states -> " << dfa.state_count << " DFA states\n";
+        dfa.finalize();
+        return true;
+    }
+}
+
+// DFA管理模块
+namespace DFAManager {
+    int state_count = 0;
+    std::vector<int> states;
+    int initial_state = 0;
+    std::vector<int> accept_states;
+    std::vector<std::tuple<int, std::string, int>> transitions; // (起点, 区间标签, 终点)
+    
+    void initialize() {
+        const DataStructures::CompactAutomaton &dfa = DataStructures::dfa;
+        states.resize(dfa.state_count);
+        std::iota(states.begin(), states.end(), 0);
+        state_count = dfa.state_count;
+
+        // 构建转移关系
+        for (int i = 0; i < state_count; i++) {
+            for (int k = dfa.transition_offsets[i]; k < dfa.transition_offsets[i + 1]; k++) {
+                transitions.push_back({i, DataStructures::range_label(dfa.transition_lo[k], dfa.transition_hi[k]),
+                                       dfa.transition_targets[k]});
+            }
+        }
+
+        // 找到接受状态
+        for (int i = 0; i < state_count; i++) {
+            if (dfa.accept_states[i]) {
+                accept_states.push_back(i);
+            }
+        }
+    }
+    
+    void print_dfa() {
+        std::cout << "\n=== DFA ===\n";
+        std::cout << "States: ";
+        for (const auto &i : states) {
+            std::cout << i << ' ';
+        }
+        std::cout << '\n';
+
+        std::cout << "Initial state: " << initial_state << '\n';
+
+        std::cout << "Transitions: ";
+        for (const auto &[from, symbol, to] : transitions) {
+            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+        }
+        std::cout << '\n';
+
+        std::cout << "Accept states: ";
+        for (const auto &i : accept_states) {
+            std::cout << i << ' ';
+        }
+        std::cout << '\n';
+    }
+}
+
+// DFA最小化模块
+namespace DFAMinimizer {
+    std::vector<int> state_partition;
+    std::vector<std::set<int>> partitions;
+    std::vector<std::tuple<int, unsigned char, unsigned char, int>> minimized_transitions; // (起点分区, lo, hi, 终点分区)
+    
+    // 可细化划分：elements 中同一块的状态连续存放，块 b 占据 [block_begin[b], block_end[b])，
+    // 其中 [block_begin[b], block_marked[b]) 为本轮被标记的状态
+    struct RefinablePartition {
+        std::vector<int> elements;
+        std::vector<int> location;
+        std::vector<int> block_of;
+        std::vector<int> block_begin;
+        std::vector<int> block_end;
+        std::vector<int> block_marked;
+
+        int block_size(int block) const {
+            return block_end[block] - block_begin[block];
+        }
+
+        void mark(int state) {
+            int block = block_of[state];
+            int position = location[state];
+            int marked_end = block_marked[block];
+            if (position < marked_end) return;
+
+            int other = elements[marked_end];
+            std::swap(elements[position], elements[marked_end]);
+            location[other] = position;
+            location[state] = marked_end;
+            block_marked[block]++;
+        }
+
+        // 把块中被标记的部分分裂成新块，返回新块编号；全部被标记时不分裂，返回 -1
+        int split(int block) {
+            int marked_end = block_marked[block];
+            if (marked_end == block_end[block]) {
+                block_marked[block] = block_begin[block];
+                return -1;
+            }
+
+            int new_block = block_begin.size();
+            block_begin.push_back(block_begin[block]);
+            block_end.push_back(marked_end);
+            block_marked.push_back(block_begin[block]);
+            for (int i = block_begin[block]; i < marked_end; i++) {
+                block_of[elements[i]] = new_block;
+            }
+            block_begin[block] = marked_end;
+            block_marked[block] = marked_end;
+            return new_block;
+        }
+    };
+
+    // Hopcroft 最小化，O(n·|Σ|·log n)，Σ 为DFA转移区间切分出的字节类。
+    // 原DFA是部分DFA，补一个编号为 n 的死状态使其完全
+    void minimize_dfa() {
+        const DataStructures::CompactAutomaton &dfa = DataStructures::dfa;
+        const int n = DFAManager::state_count;
+        const int dead_state = n;
+        const int total = n + 1;
+        DataStructures::ByteClasses classes(dfa);
+        std::vector<unsigned char> symbols; // 每个被覆盖的字节类取其首字节作代表
+        for (int c = 0; c < classes.count(); c++) {
+            if (classes.covered[c]) symbols.push_back(classes.ranges[c].first);
+        }
+        const int symbol_count = symbols.size();
+
+        // 逆向转移表：inverse_targets[inverse_offsets[a * (total + 1) + q] ...] 为经符号 a 到达 q 的状态
+        std::vector<int> inverse_offsets(symbol_count * (total + 1) + 1, 0);
+        std::vector<int> destinations(symbol_count * total);
+        for (int a = 0; a < symbol_count; a++) {
+            for (int p = 0; p < total; p++) {
+                int q = p == dead_state ? -1 : dfa.find_transition(p, symbols[a]);
+                destinations[a * total + p] = q == -1 ? dead_state : q;
+            }
+        }
+        for (int a = 0; a < symbol_count; a++) {
+            int base = a * (total + 1);
+            for (int p = 0; p < total; p++) inverse_offsets[base + destinations[a * total + p] + 1]++;
+        }
+        for (int a = 0; a < symbol_count; a++) {
+            int base = a * (total + 1);
+            int start = a * total;
+            inverse_offsets[base] = start;
+            for (int q = 0; q < total; q++) inverse_offsets[base + q + 1] += inverse_offsets[base + q];
+        }
+        std::vector<int> inverse_targets(symbol_count * total);
+        {
+            std::vector<int> fill(inverse_offsets.begin(), inverse_offsets.end());
+            for (int a = 0; a < symbol_count; a++) {
+                int base = a * (total + 1);
+                for (int p = 0; p < total; p++) {
+                    inverse_targets[fill[base + destinations[a * total + p]]++] = p;
+                }
+            }
+        }
+
+        // 初始划分：非接受状态（含死状态）与接受状态
+        RefinablePartition partition;
+        partition.elements.resize(total);
+        partition.location.resize(total);
+        partition.block_of.resize(total);
+        int accept_count = 0;
+        for (int i = 0; i < n; i++) accept_count += dfa.accept_states[i] ? 1 : 0;
+
+        int next_non_accept = 0, next_accept = total - accept_count;
+        for (int i = 0; i < total; i++) {
+            bool accepting = i < n && dfa.accept_states[i];
+            int position = accepting ? next_accept++ : next_non_accept++;
+            partition.elements[position] = i;
+            partition.location[i] = position;
+            partition.block_of[i] = accepting ? 1 : 0;
+        }
+        partition.block_begin = {0, total - accept_count};
+        partition.block_end = {total - accept_count, total};
+        partition.block_marked = partition.block_begin;
+
+        // 待处理的 (块, 符号) 分裂器
+        std::vector<std::pair<int, int>> worklist;
+        std::vector<std::vector<char>> in_worklist(2, std::vector<char>(symbol_count, 0));
+        if (accept_count > 0 && accept_count < total) {
+            int smaller = partition.block_size(1) <= partition.block_size(0) ? 1 : 0;
+            for (int a = 0; a < symbol_count; a++) {
+                worklist.push_back({smaller, a});
+                in_worklist[smaller][a] = 1;
+            }
+        }
+
+        std::vector<int> splitter;
+        std::vector<int> touched_blocks;
+        while (!worklist.empty()) {
+            auto [splitter_block, a] = worklist.back();
+            worklist.pop_back();
+            in_worklist[splitter_block][a] = 0;
+
+            // 复制分裂器的状态：标记过程中块内元素会被移动
+            splitter.assign(partition.elements.begin() + partition.block_begin[splitter_block],
+                            partition.elements.begin() + partition.block_end[splitter_block]);
+
+            touched_blocks.clear();
+            int base = a * (total + 1);
+            for (int q : splitter) {
+                for (int k = inverse_offsets[base + q]; k < inverse_offsets[base + q + 1]; k++) {
+                    int p = inverse_targets[k];
+                    int block = partition.block_of[p];
+                    if (partition.block_marked[block] == partition.block_begin[block]) {
+                        touched_blocks.push_back(block);
+                    }
+                    partition.mark(p);
+                }
+            }
+
+            for (int block : touched_blocks) {
+                int new_block = partition.split(block);
+                if (new_block == -1) continue;
+
+                in_worklist.push_back(std::vector<char>(symbol_count, 0));
+                for (int b = 0; b < symbol_count; b++) {
+                    if (in_worklist[block][b]) {
+                        worklist.push_back({new_block, b});
+                        in_worklist[new_block][b] = 1;
+                    } else {
+                        int smaller = partition.block_size(new_block) <= partition.block_size(block) ? new_block : block;
+                        worklist.push_back({smaller, b});
+                        in_worklist[smaller][b] = 1;
+                    }
+                }
+            }
+        }
+
+        // 输出分区：去掉补充的死状态，按最小成员排序以保持编号稳定
+        std::vector<std::set<int>> blocks(partition.block_begin.size());
+        for (int i = 0; i < n; i++) {
+            blocks[partition.block_of[i]].insert(i);
+        }
+        partitions.clear();
+        for (auto &block : blocks) {
+            if (!block.empty()) partitions.push_back(std::move(block));
+        }
+        std::sort(partitions.begin(), partitions.end(),
+            [](const std::set<int> &x, const std::set<int> &y) { return *x.begin() < *y.begin(); });
+
+        state_partition.assign(n, 0);
+        for (int i = 0; i < partitions.size(); i++) {
+            for (int state : partitions[i]) {
+                state_partition[state] = i;
+            }
+        }
+        
+        // 构建最小化后的转移关系：取每个分区的最小成员作代表，目标分区相同的相邻区间合并
+        minimized_transitions.clear();
+        for (int i = 0; i < partitions.size(); i++) {
+            int representative = *partitions[i].begin();
+            for (int k = dfa.transition_offsets[representative]; k < dfa.transition_offsets[representative + 1]; k++) {
+                int target = state_partition[dfa.transition_targets[k]];
+                if (!minimized_transitions.empty()) {
+                    auto &[from, lo, hi, to] = minimized_transitions.back();
+                    if (from == i && to == target && hi + 1 == dfa.transition_lo[k]) {
+                        hi = dfa.transition_hi[k];
+                        continue;
+                    }
+                }
+                minimized_transitions.push_back({i, dfa.transition_lo[k], dfa.transition_hi[k], target});
+            }
+        }
+    }
+    
+    void print_minimized_dfa() {
+        std::cout << "\n=== Minimized DFA ===\n";
+        std::cout << "Partitions: " << partitions.size() << "\n";
+        for (int i = 0; i < partitions.size(); i++) {
+            std::cout << "Partition " << i << ": {";
+            bool first = true;
+            for (auto state : partitions[i]) {
+                if (!first) std::cout << ", ";
+                std::cout << state;
+                first = false;
+            }
+            std::cout << "}\n";
+        }
+        
+        std::cout << "Minimized Transitions: ";
+        for (const auto& [from, lo, hi, to] : minimized_transitions) {
+            std::cout << "f(" << from << ", " << DataStructures::range_label(lo, hi) << ") = " << to << " ";
+        }
+        std::cout << "\n";
+    }
+    
+    void export_to_dot(const std::string &filename) {
+        std::ofstream out(filename);
+        out << "digraph DFA {\n";
+        out << "  rankdir=LR;\n";
+
+        // 确定接受状态
+        std::set<int> accept_partitions;
+        for (const auto &state : DFAManager::accept_states) {
+            accept_partitions.insert(state_partition[state]);
+        }
+        
+        // 输出非接受状态
+        out << "  node [shape = circle];\n";
+        for (int i = 0; i < partitions.size(); ++i) {
+            if (accept_partitions.find(i) == accept_partitions.end()) {
+                out << "  " << i << ";\n";
+            }
+        }
+        
+        // 输出接受状态
+        if (!accept_partitions.empty()) {
+            out << "  node [shape = doublecircle];\n";
+            for (int state : accept_partitions) {
+                out << "  " << state << ";\n";
+            }
+        }
+        
+        // 初始状态箭头
+        int initial_partition = state_partition[0];
+        out << "  __start [shape=point];\n";
+        out << "  __start -> " << initial_partition << ";\n";
+        
+        // 输出转移关系
+        for (const auto &[src, lo, hi, dest] : minimized_transitions) {
+            out << "  " << src << " -> " << dest << " [label=\"" << DataStructures::range_label(lo, hi) << "\"];\n";
+        }
+        
+        out << "}\n";
+        out.close();
+    }
+}
+
+// 稠密DFA模块 - 把最小化DFA编译成 "状态 × 字节类" 的平铺转移表，匹配时每个字节只查一次表
+namespace DenseDFA {
+    const int DEAD_STATE = 0; // 显式死状态，所有字节类都转回自身
+    const int MAX_ESCAPE_BYTES = 3; // 离开自环的字节不超过该数目的状态标记为加速状态
+
+    // 加速状态：除 escapes 中的字节外都转回自身，匹配时直接扫描到下一个逃逸字节
+    struct Accelerator {
+        unsigned char escapes[MAX_ESCAPE_BYTES];
+        int count;
+    };
+
+    struct Table {
+        int state_count = 0;                 // 含死状态
+        int class_count = 0;                 // 字节类个数
+        int start_state = DEAD_STATE;        // 已乘以 class_count 的行偏移
+        std::vector<unsigned char> byte_classes = std::vector<unsigned char>(256, 0);
+        std::vector<int> transitions;        // transitions[行偏移 + 字节类] = 下一状态的行偏移
+        std::vector<uint64_t> accept_bitmap; // 按状态编号（未乘 class_count）存放
+        std::vector<int> state_to_partition; // 稠密编号 -> 最小化DFA分区号（死状态为 -1）
+        int accelerated_start = 0;           // 加速状态排在最后，行偏移不小于该值即为加速状态
+        std::vector<Accelerator> accelerators; // 按加速状态的先后顺序
+
+        bool is_accept(int row) const {
+            int state = row / class_count;
+            return (accept_bitmap[state >> 6] >> (state & 63)) & 1;
+        }
+    };
+
+    Table compiled;
+
+    // 一次检查8个字节中是否有某个字节等于 pattern 中广播的字节（SWAR）
+    inline uint64_t has_byte(uint64_t word, uint64_t pattern) {
+        uint64_t v = word ^ pattern;
+        return (v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL;
+    }
+
+    // 返回 [from, size) 中第一个逃逸字节的位置，没有时返回 size；单个字节直接用 memchr
+    size_t find_escape(const Accelerator &accel, const unsigned char *data, size_t from, size_t size) {
+        if (accel.count == 1) {
+            const void *hit = std::memchr(data + from, accel.escapes[0], size - from);
+            return hit ? (const unsigned char *)hit - data : size;
+        }
+        uint64_t patterns[MAX_ESCAPE_BYTES];
+        for (int k = 0; k < accel.count; k++) patterns[k] = accel.escapes[k] * 0x0101010101010101ULL;
+        for (; from + 8 <= size; from += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + from, 8);
+            uint64_t found = 0;
+            for (int k = 0; k < accel.count; k++) found |= has_byte(word, patterns[k]);
+            if (found) break;
+        }
+        for (; from < size; from++) {
+            for (int k = 0; k < accel.count; k++) {
+                if (data[from] == accel.escapes[k]) return from;
+            }
+        }
+        return size;
+    }
+
+    // 由最小化DFA构建稠密表
+    void compile() {
+        Table table;
+        int partition_count = DFAMinimizer::partitions.size();
+        int initial_partition = DFAMinimizer::state_partition[DFAManager::initial_state];
+
+        std::vector<std::vector<int>> moves(partition_count, std::vector<int>(256, -1));
+        for (const auto &[from, lo, hi, to] : DFAMinimizer::minimized_transitions) {
+            for (int byte = lo; byte <= hi; byte++) moves[from][byte] = to;
+        }
+
+        // 字节类：在所有状态上转移都相同的字节归为一类（没有任何转移的字节全部落入同一类）
+        std::map<std::vector<int>, int> column_classes;
+        for (int byte = 0; byte < 256; byte++) {
+            std::vector<int> column(partition_count);
+            for (int p = 0; p < partition_count; p++) column[p] = moves[p][byte];
+
+            auto it = column_classes.find(column);
+            if (it == column_classes.end()) {
+                it = column_classes.emplace(column, column_classes.size()).first;
+            }
+            table.byte_classes[byte] = it->second;
+        }
+        table.class_count = column_classes.size();
+
+        // 热状态优先：从初始状态按广度优先编号，0号留给死状态
+        std::vector<int> partition_to_state(partition_count, -1);
+        table.state_to_partition.push_back(-1);
+        std::queue<int> queue;
+        partition_to_state[initial_partition] = 1;
+        table.state_to_partition.push_back(initial_partition);
+        queue.push(initial_partition);
+        while (!queue.empty()) {
+            int partition = queue.front();
+            queue.pop();
+            for (int byte = 0; byte < 256; byte++) {
+                int next = moves[partition][byte];
+                if (next != -1 && partition_to_state[next] == -1) {
+                    partition_to_state[next] = table.state_to_partition.size();
+                    table.state_to_partition.push_back(next);
+                    queue.push(next);
+                }
+            }
+        }
+        table.state_count = table.state_to_partition.size();
+
+        // 加速分析：逃逸字节（转移不回到自身的字节，包括落入死状态的）不超过 MAX_ESCAPE_BYTES 个的状态
+        // 移到编号末尾，其余状态保持广度优先的顺序
+        std::vector<int> ordinary = {-1}, accelerated;
+        std::vector<Accelerator> accelerators;
+        for (int state = 1; state < table.state_count; state++) {
+            int partition = table.state_to_partition[state];
+            Accelerator accel{{}, 0};
+            for (int byte = 0; byte < 256 && accel.count <= MAX_ESCAPE_BYTES; byte++) {
+                if (moves[partition][byte] == partition) continue;
+                if (accel.count < MAX_ESCAPE_BYTES) accel.escapes[accel.count] = byte;
+                accel.count++;
+            }
+            if (accel.count <= MAX_ESCAPE_BYTES) {
+                accelerated.push_back(partition);
+                accelerators.push_back(accel);
+            } else {
+                ordinary.push_back(partition);
+            }
+        }
+        table.state_to_partition = ordinary;
+        table.state_to_partition.insert(table.state_to_partition.end(), accelerated.begin(), accelerated.end());
+        for (int state = 1; state < table.state_count; state++) {
+            partition_to_state[table.state_to_partition[state]] = state;
+        }
+        table.accelerated_start = ordinary.size() * table.class_count;
+        table.accelerators = std::move(accelerators);
+
+        // 填表：缺省转移指向死状态；表项直接存目标行偏移，省去匹配时的乘法
+        std::vector<int> class_representative(table.class_count);
+        for (int byte = 255; byte >= 0; byte--) class_representative[table.byte_classes[byte]] = byte;
+
+        table.transitions.assign(table.state_count * table.class_count, DEAD_STATE);
+        for (int state = 1; state < table.state_count; state++) {
+            int partition = table.state_to_partition[state];
+            for (int cls = 0; cls < table.class_count; cls++) {
+                int next = moves[partition][class_representative[cls]];
+                if (next != -1) {
+                    table.transitions[state * table.class_count + cls] = partition_to_state[next] * table.class_count;
+                }
+            }
+        }
+        table.start_state = partition_to_state[initial_partition] * table.class_count;
+
+        // 接受位图
+        std::set<int> accept_partitions;
+        for (int state : DFAManager::accept_states) {
+            accept_partitions.insert(DFAMinimizer::state_partition[state]);
+        }
+        table.accept_bitmap.assign((table.state_count + 63) / 64, 0);
+        for (int state = 1; state < table.state_count; state++) {
+            if (accept_partitions.count(table.state_to_partition[state])) {
+                table.accept_bitmap[state >> 6] |= uint64_t(1) << (state & 63);
+            }
+        }
+
+        compiled = std::move(table);
+    }
+
+    bool match_range(const Table &table, const unsigned char *data, size_t size) {
+        const int *transitions = table.transitions.data();
+        const unsigned char *classes = table.byte_classes.data();
+        int row = table.start_state;
+        for (size_t position = 0; position < size; position++) {
+            if (row >= table.accelerated_start) {
+                const Accelerator &accel = table.accelerators[(row - table.accelerated_start) / table.class_count];
+                position = find_escape(accel, data, position, size);
+                if (position == size) break;
+            }
+            row = transitions[row + classes[data[position]]];
+            if (row == DEAD_STATE) return false;
+        }
+        return table.is_accept(row);
+    }
+
+    bool match(const Table &table, const std::string &input) {
+        return match_range(table, (const unsigned char *)input.data(), input.size());
+    }
+
+    // 逐行整行匹配，记录匹配行的起始偏移。不先切分行，而是一次扫过整段输入：要求表中换行总是落入死状态，
+    // 此时按换行前的状态判断该行，再从下一行开头的初始状态继续；自环状态（含接受后只等换行的状态）照常加速
+    void match_lines(const Table &table, const unsigned char *data, size_t size, std::vector<size_t> &lines) {
+        const int *transitions = table.transitions.data();
+        const unsigned char *classes = table.byte_classes.data();
+        int row = table.start_state;
+        size_t line = 0;
+        for (size_t position = 0; position < size; position++) {
+            if (row >= table.accelerated_start) {
+                const Accelerator &accel = table.accelerators[(row - table.accelerated_start) / table.class_count];
+                position = find_escape(accel, data, position, size);
+                if (position == size) break;
+            }
+            int next = transitions[row + classes[data[position]]];
+            if (next != DEAD_STATE) {
+                row = next;
+                continue;
+            }
+
+            if (data[position] != '\n') {
+                // 行内就已失败：跳到下一行
+                const void *newline = std::memchr(data + position, '\n', size - position);
+                if (!newline) return;
+                position = (const unsigned char *)newline - data;
+            } else if (table.is_accept(row)) {
+                lines.push_back(line);
+            }
+            line = position + 1;
+            row = table.start_state;
+        }
+        if (line < size && table.is_accept(row)) lines.push_back(line);
+    }
+
+    const int BATCH_LANES = 8; // 同时推进的输入个数
+
+    // 批量匹配：BATCH_LANES 个输入交错推进，每轮每条通道读一个字节。各通道的查表链互不依赖，
+    // 一条通道等待访存时其他通道可以继续执行；某个输入结束或进入死状态后通道立即换上下一个输入。
+    // 输入通常很短，不走加速状态的扫描。verdicts 的第 i 位为第 i 个输入的结果（调用方已清零）
+    void match_batch(const Table &table, const std::vector<std::string> &inputs, std::vector<uint64_t> &verdicts) {
+        const int *transitions = table.transitions.data();
+        const unsigned char *classes = table.byte_classes.data();
+        const unsigned char *data[BATCH_LANES];
+        size_t remaining[BATCH_LANES];
+        size_t index[BATCH_LANES];
+        int rows[BATCH_LANES];
+        size_t next = 0;
+        auto load = [&](int lane) {
+            data[lane] = (const unsigned char *)inputs[next].data();
+            remaining[lane] = inputs[next].size();
+            index[lane] = next++;
+            rows[lane] = table.start_state;
+        };
+
+        int active = 0;
+        while (active < BATCH_LANES && next < inputs.size()) load(active++);
+        while (active > 0) {
+            for (int k = 0; k < active; k++) {
+                if (remaining[k] > 0) {
+                    rows[k] = transitions[rows[k] + classes[*data[k]++]];
+                    remaining[k]--;
+                    if (rows[k] != DEAD_STATE) continue;
+                }
+
+                // 输入结束或进入死状态：记录结果，换上下一个输入，没有时把最后一条通道移到这里
+                if (remaining[k] == 0 && rows[k] != DEAD_STATE && table.is_accept(rows[k])) {
+                    verdicts[index[k] >> 6] |= uint64_t(1) << (index[k] & 63);
+                }
+                if (next < inputs.size()) {
+                    load(k);
+                } else {
+                    active--;
+                    data[k] = data[active];
+                    remaining[k] = remaining[active];
+                    index[k] = index[active];
+                    rows[k] = rows[active];
+                    k--;
+                }
+            }
+        }
+    }
+}
+
+// 惰性DFA模块 - 完整DFA过大时只确定化输入实际到达的状态；状态缓存有上限，
+// 满了就清空，清空过于频繁（抖动）时退回NFA模拟
+namespace LazyDFA {
+    const int MAX_CACHED_STATES = 1024;
+    const int UNKNOWN = -1;
+    const int DEAD = -2;
+    const int MIN_BYTES_PER_STATE = 10; // 两次清空之间平均每个缓存状态处理的字节数低于该值视为一次抖动
+    const int MAX_THRASH_COUNT = 2;
+
+    struct CachedState {
+        std::vector<int> nfa_states; // 有序的NFA状态集合（已ε闭包）
+        bool accept = false;
+        std::vector<int> next = std::vector<int>(256, UNKNOWN);
+    };
+
+    int nfa_start_state = 0;
+    std::vector<CachedState> cache;
+    std::unordered_map<std::vector<int>, int, DFAConverter::StateSetHash> cache_index;
+    int cache_clear_count = 0;     // 累计清空次数
+    bool last_match_used_nfa = false;
+
+    void reset(int start_state) {
+        nfa_start_state = start_state;
+        cache.clear();
+        cache_index.clear();
+        cache_clear_count = 0;
+        last_match_used_nfa = false;
+    }
+
+    int intern(const std::vector<int> &states) {
+        auto it = cache_index.find(states);
+        if (it != cache_index.end()) return it->second;
+
+        CachedState state;
+        state.nfa_states = states;
+        for (int nfa_state : states) {
+            if (DataStructures::nfa.accept_states[nfa_state]) {
+                state.accept = true;
+                break;
+            }
+        }
+        cache.push_back(std::move(state));
+        cache_index.emplace(states, cache.size() - 1);
+        return cache.size() - 1;
+    }
+
+    // 集合 states 读入字节 c 后的ε闭包（有序），结果放入 result
+    void step(const std::vector<int> &states, unsigned char c, DFAConverter::SparseSet &work,
+              std::vector<int> &stack, std::vector<int> &result) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        work.clear();
+        for (int state : states) {
+            for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                if (nfa.accepts_byte(k, c)) work.insert(nfa.transition_targets[k]);
+            }
+        }
+        DFAConverter::compute_epsilon_closure(work, stack);
+        result = work.dense;
+        std::sort(result.begin(), result.end());
+    }
+
+    // NFA模拟：从状态集合 states 开始处理 input[position..]，两个稀疏集合交替使用，不排序
+    bool simulate_nfa(const std::vector<int> &states, const std::string &input, size_t position,
+                      DFAConverter::SparseSet &work, std::vector<int> &stack) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        DFAConverter::SparseSet next(nfa.state_count);
+        work.clear();
+        for (int state : states) work.insert(state);
+
+        for (size_t i = position; i < input.size(); i++) {
+            unsigned char c = input[i];
+            next.clear();
+            for (int state : work.dense) {
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    if (nfa.accepts_byte(k, c)) next.insert(nfa.transition_targets[k]);
+                }
+            }
+            DFAConverter::compute_epsilon_closure(next, stack);
+            if (next.dense.empty()) return false;
+            std::swap(work, next);
+        }
+        for (int state : work.dense) {
+            if (nfa.accept_states[state]) return true;
+        }
+        return false;
+    }
+
+    bool match(const std::string &input) {
+        DFAConverter::SparseSet work(DataStructures::nfa.state_count);
+        std::vector<int> stack;
+        std::vector<int> next_states;
+        last_match_used_nfa = false;
+
+        work.insert(nfa_start_state);
+        DFAConverter::compute_epsilon_closure(work, stack);
+        std::vector<int> start_states = work.dense;
+        std::sort(start_states.begin(), start_states.end());
+        if (cache.size() >= MAX_CACHED_STATES) {
+            cache.clear();
+            cache_index.clear();
+            cache_clear_count++;
+        }
+        int current = intern(start_states);
+
+        size_t last_clear_position = 0;
+        int thrash_count = 0;
+
+        for (size_t i = 0; i < input.size(); i++) {
+            unsigned char c = input[i];
+            int next = cache[current].next[c];
+
+            if (next == UNKNOWN) {
+                step(cache[current].nfa_states, c, work, stack, next_states);
+                if (next_states.empty()) {
+                    next = DEAD;
+                } else {
+                    auto it = cache_index.find(next_states);
+                    if (it != cache_index.end()) {
+                        next = it->second;
+                    } else {
+                        if (cache.size() >= MAX_CACHED_STATES) {
+                            if (i - last_clear_position < (size_t)MIN_BYTES_PER_STATE * MAX_CACHED_STATES &&
+                                ++thrash_count >= MAX_THRASH_COUNT) {
+                                std::cout << "Lazy DFA thrashing, falling back to NFA simulation at byte " << i << "\n";
+                                last_match_used_nfa = true;
+                                return simulate_nfa(cache[current].nfa_states, input, i, work, stack);
+                            }
+
+                            // 清空缓存，只保留当前状态
+                            std::vector<int> current_states = std::move(cache[current].nfa_states);
+                            cache.clear();
+                            cache_index.clear();
+                            cache_clear_count++;
+                            last_clear_position = i;
+                            current = intern(current_states);
+                        }
+                        next = intern(next_states);
+                    }
+                }
+                cache[current].next[c] = next;
+            }
+
+            if (next == DEAD) return false;
+            current = next;
+        }
+
+        return cache[current].accept;
+    }
+}
+
+// Pike VM模块 - 直接在NFA上模拟，线程表为稀疏集合，每个线程带捕获槽；
+// 时间 O(n·m)，空间 O(m)，不需要构建DFA
+namespace PikeVM {
+    struct ThreadList {
+        DFAConverter::SparseSet states;
+        std::vector<int> slots; // 第 i 个线程（states.dense[i]）的捕获槽位于 [i * slot_count, (i + 1) * slot_count)
+
+        ThreadList(int state_count, int slot_count)
+            : states(state_count), slots(state_count * slot_count, -1) {}
+    };
+
+    // 深度优先加入线程的栈帧：探索某状态，或回溯时恢复某个捕获槽
+    struct Frame {
+        bool restore;
+        int value;      // 探索：状态；恢复：槽号
+        int old_value;
+    };
+
+    // 沿ε转移加入线程，进入状态时执行其捕获记录；按ε边顺序决定优先级（先加入者优先）
+    void add_thread(ThreadList &list, int start, int position, std::vector<int> &captures,
+                    int slot_count, std::vector<Frame> &stack) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        stack.push_back({false, start, 0});
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            if (frame.restore) {
+                captures[frame.value] = frame.old_value;
+                continue;
+            }
+
+            int state = frame.value;
+            if (list.states.contains(state)) continue;
+            list.states.insert(state);
+
+            for (int k = nfa.save_offsets[state]; k < nfa.save_offsets[state + 1]; k++) {
+                int slot = nfa.save_slots[k];
+                stack.push_back({true, slot, captures[slot]});
+                captures[slot] = position;
+            }
+            std::copy(captures.begin(), captures.end(),
+                      list.slots.begin() + (list.states.dense.size() - 1) * slot_count);
+
+            for (int k = nfa.epsilon_offsets[state + 1] - 1; k >= nfa.epsilon_offsets[state]; k--) {
+                stack.push_back({false, nfa.epsilon_targets[k], 0});
+            }
+        }
+    }
+
+    // 锚定匹配整个输入；成功时 groups[k] 为第 k 组的 [start, end)，groups[0] 为整个输入
+    bool match(int start_state, int group_count, const std::string &input,
+               std::vector<std::pair<int, int>> &groups) {
+        const DataStructures::CompactAutomaton &nfa = DataStructures::nfa;
+        const int slot_count = 2 * (group_count + 1);
+        ThreadList current(nfa.state_count, slot_count);
+        ThreadList next(nfa.state_count, slot_count);
+        std::vector<int> captures(slot_count, -1);
+        std::vector<Frame> stack;
+
+        add_thread(current, start_state, 0, captures, slot_count, stack);
+
+        for (size_t position = 0; position < input.size() && !current.states.dense.empty(); position++) {
+            unsigned char c = input[position];
+            next.states.clear();
+            for (size_t i = 0; i < current.states.dense.size(); i++) {
+                int state = current.states.dense[i];
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    if (!nfa.accepts_byte(k, c)) continue;
+                    std::copy(current.slots.begin() + i * slot_count,
+                              current.slots.begin() + (i + 1) * slot_count, captures.begin());
+                    add_thread(next, nfa.transition_targets[k], position + 1, captures, slot_count, stack);
+                }
+            }
+            std::swap(current, next);
+            if (current.states.dense.empty()) return false;
+        }
+
+        // 优先级最高的接受线程给出捕获结果
+        for (size_t i = 0; i < current.states.dense.size(); i++) {
+            if (!nfa.accept_states[current.states.dense[i]]) continue;
+
+            groups.assign(group_count + 1, {-1, -1});
+            groups[0] = {0, (int)input.size()};
+            for (int group = 1; group <= group_count; group++) {
+                int begin = current.slots[i * slot_count + 2 * group];
+                int end = current.slots[i * slot_count + 2 * group + 1];
+                if (begin != -1 && end != -1 && begin <= end) groups[group] = {begin, end};
+            }
+            return true;
+        }
+        return false;
+    }
+}
+
+// 带标签的DFA模块（TDFA）- 在确定性自动机上提取捕获组。
+// 状态为按优先级排列的NFA状态列表（只保留有字节转移的状态和接受状态），与Pike VM的线程表一一对应；
+// 列表中第 i 个配置的第 t 个标签存放在寄存器 i * tag_count + t 中。每条转移附带寄存器操作：
+// 把来源配置的寄存器复制过来，或写入当前位置（闭包中经过了捕获标记），优先级规则与Pike VM相同，
+// 因此匹配时每个字节只查一次表并执行若干寄存器操作，时间与输入长度成线性，没有回溯
+namespace TaggedDFA {
+    const int MAX_OPERATIONS = 1 << 20; // 寄存器操作总数上限，超过后放弃构建，退回Pike VM
+
+    // target <- source；source 为 -1 表示写入当前位置（已读字节数）
+    struct Operation {
+        int target;
+        int source;
+    };
+
+    struct Table {
+        bool ready = false;
+        int tag_count = 0;      // 2 * 捕获组数，标签 t 对应捕获槽 t + 2
+        int register_count = 0; // 最后一个为并行复制拆环用的临时寄存器
+        int class_count = 0;
+        int state_count = 0;
+        std::vector<int> class_of = std::vector<int>(256, 0);
+        std::vector<int> transitions;        // state * class_count + c -> 目标状态，-1 为死状态
+        std::vector<int> operation_offsets;  // 同一下标的寄存器操作位于 [offsets[i], offsets[i + 1])
+        std::vector<Operation> operations;
+        std::vector<Operation> initial_operations; // 位置 0 处初始闭包的标签
+        std::vector<int> final_config;       // 优先级最高的接受配置，-1 表示非接受状态
+    };
+
+    Table compiled;
+
+    // 一步闭包的结果：第 i 个配置的NFA状态、来源配置，以及本步闭包中写入的标签
+    struct Closure {
+        std::vector<int> states;
+        std::vector<int> sources;
+        std::vector<char> tagged; // 第 i 个配置位于 [i * tag_count, (i + 1) * tag_count)
+    };
+
+    struct Frame {
+        bool restore;
+        int value;
+        int old_value;
+    };
+
+    // 按Pike VM add_thread 的顺序沿ε转移展开；seeds 为 (目标状态, 来源配置)，按优先级排列
+    void closure(const DataStructures::CompactAutomaton &nfa, const std::vector<std::pair<int, int>> &seeds,
+                 int tag_count, DFAConverter::SparseSet &visited, Closure &result) {
+        result.states.clear();
+        result.sources.clear();
+        result.tagged.clear();
+        visited.clear();
+        std::vector<char> tagged(tag_count, 0);
+        std::vector<Frame> stack;
+        for (const auto &[seed, source] : seeds) {
+            stack.push_back({false, seed, 0});
+            while (!stack.empty()) {
+                Frame frame = stack.back();
+                stack.pop_back();
+                if (frame.restore) {
+                    tagged[frame.value] = frame.old_value;
+                    continue;
+                }
+
+                int state = frame.value;
+                if (visited.contains(state)) continue;
+                visited.insert(state);
+
+                for (int k = nfa.save_offsets[state]; k < nfa.save_offsets[state + 1]; k++) {
+                    int tag = nfa.save_slots[k] - 2;
+                    if (tag < 0 || tag >= tag_count) continue;
+                    stack.push_back({true, tag, tagged[tag]});
+                    tagged[tag] = 1;
+                }
+                bool has_transitions = nfa.transition_offsets[state] < nfa.transition_offsets[state + 1];
+                if (has_transitions || nfa.accept_states[state]) {
+                    result.states.push_back(state);
+                    result.sources.push_back(source);
+                    result.tagged.insert(result.tagged.end(), tagged.begin(), tagged.end());
+                }
+
+                for (int k = nfa.epsilon_offsets[state + 1] - 1; k >= nfa.epsilon_offsets[state]; k--) {
+                    stack.push_back({false, nfa.epsilon_targets[k], 0});
+                }
+            }
+        }
+    }
+
+    // 把一组并行赋值（每个目标只写一次）排成顺序执行的操作：目标不再被其他待执行操作读取时才写入，
+    // 只剩环时把环上一个目标的旧值存入临时寄存器
+    void sequentialize(std::vector<Operation> pending, int temporary, std::vector<Operation> &out) {
+        while (!pending.empty()) {
+            bool progressed = false;
+            for (size_t i = 0; i < pending.size(); i++) {
+                int target = pending[i].target;
+                bool read = std::any_of(pending.begin(), pending.end(),
+                                        [&](const Operation &op) { return op.source == target; });
+                if (read) continue;
+                out.push_back(pending[i]);
+                pending.erase(pending.begin() + i);
+                progressed = true;
+                break;
+            }
+            if (progressed) continue;
+
+            int target = pending.front().target;
+            out.push_back({temporary, target});
+            for (auto &op : pending) {
+                if (op.source == target) op.source = temporary;
+            }
+        }
+    }
+
+    // 从NFA构建TDFA；转移数（状态数 × 字节类数）或寄存器操作数超限时返回 false（compiled 保持未就绪）
+    bool build(const DataStructures::CompactAutomaton &nfa, int start_state, int group_count, size_t max_transitions) {
+        compiled = Table();
+        Table table;
+        table.tag_count = 2 * group_count;
+        const int tags = table.tag_count;
+
+        DataStructures::ByteClasses classes(nfa);
+        table.class_count = classes.count();
+        table.class_of = classes.class_of;
+        const size_t max_states = std::max<size_t>(1, max_transitions / table.class_count);
+
+        std::vector<std::vector<int>> state_lists;
+        std::unordered_map<std::vector<int>, int, DFAConverter::StateSetHash> state_map;
+        DFAConverter::SparseSet visited(nfa.state_count);
+        Closure step;
+        size_t max_configs = 0;
+
+        auto intern = [&](const Closure &result) {
+            auto found = state_map.find(result.states);
+            if (found != state_map.end()) return found->second;
+            int id = state_lists.size();
+            state_map.emplace(result.states, id);
+            state_lists.push_back(result.states);
+            max_configs = std::max(max_configs, result.states.size());
+            int final_config = -1;
+            for (size_t i = 0; i < result.states.size() && final_config < 0; i++) {
+                if (nfa.accept_states[result.states[i]]) final_config = i;
+            }
+            table.final_config.push_back(final_config);
+            return id;
+        };
+
+        closure(nfa, {{start_state, -1}}, tags, visited, step);
+        intern(step);
+        for (size_t i = 0; i < step.states.size(); i++) {
+            for (int t = 0; t < tags; t++) {
+                if (step.tagged[i * tags + t]) table.initial_operations.push_back({(int)i * tags + t, -1});
+            }
+        }
+
+        // 寄存器编号依赖最大配置数，先收集并行赋值，全部状态构建完后再拆成顺序操作
+        std::vector<std::vector<Operation>> parallel;
+        std::vector<std::pair<int, int>> seeds;
+        size_t operation_count = 0;
+        for (size_t current = 0; current < state_lists.size(); current++) {
+            if (state_lists.size() > max_states) return false;
+            for (int c = 0; c < table.class_count; c++) {
+                unsigned char byte = classes.ranges[c].first;
+                seeds.clear();
+                const std::vector<int> &configs = state_lists[current];
+                for (size_t i = 0; i < configs.size(); i++) {
+                    int state = configs[i];
+                    for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                        if (nfa.accepts_byte(k, byte)) seeds.push_back({nfa.transition_targets[k], (int)i});
+                    }
+                }
+
+                std::vector<Operation> assignments;
+                if (seeds.empty()) {
+                    table.transitions.push_back(-1);
+                    parallel.push_back(assignments);
+                    continue;
+                }
+                closure(nfa, seeds, tags, visited, step);
+                table.transitions.push_back(intern(step));
+                for (size_t j = 0; j < step.states.size(); j++) {
+                    for (int t = 0; t < tags; t++) {
+                        int target = j * tags + t;
+                        int source = step.tagged[j * tags + t] ? -1 : step.sources[j] * tags + t;
+                        if (source != target) assignments.push_back({target, source});
+                    }
+                }
+                operation_count += assignments.size();
+                if (operation_count > MAX_OPERATIONS) return false;
+                parallel.push_back(std::move(assignments));
+            }
+        }
+
+        table.state_count = state_lists.size();
+        table.register_count = max_configs * tags + 1;
+        table.operation_offsets.push_back(0);
+        for (const auto &assignments : parallel) {
+            sequentialize(assignments, table.register_count - 1, table.operations);
+            table.operation_offsets.push_back(table.operations.size());
+        }
+        table.ready = true;
+        compiled = std::move(table);
+        return true;
+    }
+
+    // 锚定匹配整个输入，结果格式与 PikeVM::match 相同
+    bool match(const Table &table, const std::string &input, std::vector<std::pair<int, int>> &groups) {
+        std::vector<int> registers(table.register_count, -1);
+        for (const Operation &op : table.initial_operations) registers[op.target] = 0;
+
+        int state = 0;
+        for (size_t position = 0; position < input.size(); position++) {
+            int index = state * table.class_count + table.class_of[(unsigned char)input[position]];
+            state = table.transitions[index];
+            if (state < 0) return false;
+            for (int k = table.operation_offsets[index]; k < table.operation_offsets[index + 1]; k++) {
+                const Operation &op = table.operations[k];
+                registers[op.target] = op.source < 0 ? (int)position + 1 : registers[op.source];
+            }
+        }
+
+        int final_config = table.final_config[state];
+        if (final_config < 0) return false;
+        int group_count = table.tag_count / 2;
+        groups.assign(group_count + 1, {-1, -1});
+        groups[0] = {0, (int)input.size()};
+        for (int group = 1; group <= group_count; group++) {
+            int begin = registers[final_config * table.tag_count + 2 * group - 2];
+            int end = registers[final_config * table.tag_count + 2 * group - 1];
+            if (begin != -1 && end != -1 && begin <= end) groups[group] = {begin, end};
+        }
+        return true;
+    }
+}
+
+// 计数模拟模块 - 含计数器的NFA上的状态集合模拟。每个计数器状态保存一个计数集合：
+// 按进入时刻（已读字节数）从旧到新存放，计数值 = 当前位置 - 进入时刻，读入一个字节时所有计数同时加一，
+// 无需逐个更新；超过上界的从队首丢弃，因此每步代价与计数上界无关
+namespace CountingNFA {
+    struct Simulation {
+        const DataStructures::CompactAutomaton &nfa;
+        DFAConverter::SparseSet states;
+        std::vector<std::deque<size_t>> entries; // entries[i]：计数器 i 的进入时刻
+        std::vector<int> stack;
+
+        explicit Simulation(const DataStructures::CompactAutomaton &automaton)
+            : nfa(automaton), states(automaton.state_count), entries(automaton.counters.size()) {}
+
+        size_t oldest_count(int counter, size_t position) const {
+            return position - entries[counter].front();
+        }
+
+        // 丢弃超过上界的计数；无上界时不小于下界的计数彼此等价，只保留一个
+        void trim(int counter, size_t position) {
+            const auto &info = nfa.counters[counter];
+            std::deque<size_t> &queue = entries[counter];
+            if (info.max != -1) {
+                while (!queue.empty() && position - queue.front() > (size_t)info.max) queue.pop_front();
+            } else {
+                while (queue.size() >= 2 && position - queue[1] >= (size_t)info.min) queue.pop_front();
+            }
+        }
+
+        // 经ε转移（或作为起点）进入状态：计数器状态记录一个新的计数 0
+        void enter(int state, size_t position) {
+            int counter = nfa.counter_of[state];
+            if (counter >= 0) {
+                std::deque<size_t> &queue = entries[counter];
+                if (queue.empty() || queue.back() != position) queue.push_back(position);
+                trim(counter, position);
+            }
+            if (!states.contains(state)) {
+                states.insert(state);
+                stack.push_back(state);
+            }
+        }
+
+        // 从 stack 中的状态出发求ε闭包；计数器状态的ε转移要求最大计数不小于下界
+        void close(size_t position) {
+            while (!stack.empty()) {
+                int state = stack.back();
+                stack.pop_back();
+                int counter = nfa.counter_of[state];
+                if (counter >= 0 && oldest_count(counter, position) < (size_t)nfa.counters[counter].min) continue;
+                for (int k = nfa.epsilon_offsets[state]; k < nfa.epsilon_offsets[state + 1]; k++) {
+                    enter(nfa.epsilon_targets[k], position);
+                }
+            }
+        }
+    };
+
+    bool match(const DataStructures::CompactAutomaton &nfa, int start_state, const unsigned char *input, size_t size) {
+        Simulation current(nfa), next(nfa);
+        current.enter(start_state, 0);
+        current.close(0);
+
+        for (size_t position = 0; position < size && !current.states.dense.empty(); position++) {
+            unsigned char c = input[position];
+            next.states.clear();
+            for (auto &queue : next.entries) queue.clear();
+
+            // 计数器自环：整个计数集合随之前进；其余转移的目标按普通方式进入
+            for (int state : current.states.dense) {
+                int counter = nfa.counter_of[state];
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    if (!nfa.accepts_byte(k, c)) continue;
+                    int target = nfa.transition_targets[k];
+                    if (counter >= 0 && target == state) {
+                        next.entries[counter] = current.entries[counter];
+                        next.trim(counter, position + 1);
+                        if (!next.entries[counter].empty() && !next.states.contains(state)) {
+                            next.states.insert(state);
+                            next.stack.push_back(state);
+                        }
+                        break;
+                    }
+                }
+            }
+            for (int state : current.states.dense) {
+                int counter = nfa.counter_of[state];
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    int target = nfa.transition_targets[k];
+                    if (counter >= 0 && target == state) continue;
+                    if (nfa.accepts_byte(k, c)) next.enter(target, position + 1);
+                }
+            }
+            next.close(position + 1);
+            std::swap(current.states, next.states);
+            std::swap(current.entries, next.entries);
+        }
+
+        for (int state : current.states.dense) {
+            if (nfa.accept_states[state]) return true;
+        }
+        return false;
+    }
+
+    bool match(const DataStructures::CompactAutomaton &nfa, int start_state, const std::string &input) {
+        return match(nfa, start_state, (const unsigned char *)input.data(), input.size());
+    }
+}
+
+// 流式搜索模块 - 无锚点、最左最长、互不重叠地查找所有匹配
+// 前向：带隐式 .* 前缀的惰性DFA，状态为按起点先后排列的NFA线程组，用于确定匹配终点；
+// 反向：在反转的NFA上构建的惰性DFA，从终点向前扫描，最长反向匹配即为匹配起点
+// 搜索预过滤模块：无锚点搜索时大部分位置不可能开始匹配。从语法树提取匹配必然以之开头的字面量集合，
+// 前向DFA处于空闲状态（没有进行中的匹配）时，直接跳到下一个可能的起点，跳过的字节不经过DFA
+namespace Prefilter {
+    const int MAX_LITERALS = 16;      // 字面量集合的上限，超过后放弃
+    const int MAX_LITERAL_LENGTH = 8; // 字面量截断长度
+    const int MAX_SKIP_BYTES = 128;   // 退回首字节集合时，集合超过该大小则不做预过滤
+    const size_t PROBATION_CALLS = 256; // 查找这么多次之后，平均每次跳过的字节数不足 MIN_AVERAGE_SKIP 则停用
+    const size_t MIN_AVERAGE_SKIP = 4;
+
+    // complete 为 true 表示字面量之后的模式可以继续接上（即字面量恰好是到目前为止的完整匹配）
+    struct Literal {
+        std::string bytes;
+        bool complete;
+    };
+
+    // any 为 true 表示匹配可以以任意字节串开头（无法提取）
+    struct LiteralSet {
+        bool any = false;
+        std::vector<Literal> literals;
+    };
+
+    LiteralSet any_set() {
+        return {true, {}};
+    }
+
+    LiteralSet empty_string() {
+        return {false, {{"", true}}};
+    }
+
+    // 后面不再能接上任何东西；含空串时任何位置都可能开始匹配
+    LiteralSet cut(LiteralSet set) {
+        for (auto &literal : set.literals) {
+            if (literal.bytes.empty()) return any_set();
+            literal.complete = false;
+        }
+        return set;
+    }
+
+    LiteralSet unite(LiteralSet a, const LiteralSet &b) {
+        if (a.any || b.any) return any_set();
+        a.literals.insert(a.literals.end(), b.literals.begin(), b.literals.end());
+        if ((int)a.literals.size() > MAX_LITERALS) return any_set();
+        return a;
+    }
+
+    LiteralSet concat(const LiteralSet &a, const LiteralSet &b) {
+        if (a.any) return a;
+        size_t size = 0;
+        for (const auto &literal : a.literals) size += literal.complete ? b.literals.size() : 1;
+        if (b.any || size > MAX_LITERALS) return cut(a);
+
+        LiteralSet result;
+        for (const auto &literal : a.literals) {
+            if (!literal.complete) {
+                result.literals.push_back(literal);
+                continue;
+            }
+            for (const auto &next : b.literals) {
+                Literal joined{literal.bytes + next.bytes, next.complete};
+                if ((int)joined.bytes.size() >= MAX_LITERAL_LENGTH) {
+                    joined.bytes.resize(MAX_LITERAL_LENGTH);
+                    joined.complete = false;
+                }
+                result.literals.push_back(std::move(joined));
+            }
+        }
+        return result;
+    }
+
+    LiteralSet extract(const RegexParser::NodePtr &node) {
+        using RegexParser::NodeType;
+        switch (node->type) {
+            case NodeType::Empty:
+                return empty_string();
+            case NodeType::Class: {
+                LiteralSet set;
+                for (const auto &[lo, hi] : node->ranges) {
+                    if ((int)set.literals.size() + hi - lo + 1 > MAX_LITERALS) return any_set();
+                    for (int byte = lo; byte <= hi; byte++) set.literals.push_back({std::string(1, (char)byte), true});
+                }
+                return set;
+            }
+            case NodeType::Concat: {
+                LiteralSet set = empty_string();
+                for (const auto &child : node->children) {
+                    set = concat(set, extract(child));
+                    if (set.any) break;
+                }
+                return set;
+            }
+            case NodeType::Alternate: {
+                LiteralSet set;
+                for (const auto &child : node->children) {
+                    set = unite(std::move(set), extract(child));
+                    if (set.any) break;
+                }
+                return set;
+            }
+            case NodeType::Group:
+                return extract(node->children[0]);
+            case NodeType::Optional:
+                return unite(extract(node->children[0]), empty_string());
+            case NodeType::Star:
+                return unite(cut(extract(node->children[0])), empty_string());
+            case NodeType::Plus:
+                return cut(extract(node->children[0]));
+            case NodeType::Repeat: {
+                LiteralSet set = cut(extract(node->children[0]));
+                return node->min == 0 ? unite(std::move(set), empty_string()) : set;
+            }
+            default:
+                return any_set();
+        }
+    }
+
+    // 匹配必然以其中之一开头的字面量（去掉以另一个字面量为前缀的多余项）；无法提取或模式可匹配空串时为空
+    std::vector<std::string> required_prefixes(const RegexParser::NodePtr &root) {
+        LiteralSet set = extract(root);
+        std::vector<std::string> result;
+        if (set.any) return result;
+        for (const auto &literal : set.literals) {
+            if (literal.bytes.empty()) return {};
+            result.push_back(literal.bytes);
+        }
+        // 排序后以某项为前缀的字面量紧跟在它后面
+        std::sort(result.begin(), result.end());
+        std::vector<std::string> minimal;
+        for (const auto &literal : result) {
+            if (!minimal.empty() && literal.compare(0, minimal.back().size(), minimal.back()) == 0) continue;
+            minimal.push_back(literal);
+        }
+        return minimal;
+    }
+
+    // 在文本中查找下一个可能的匹配起点
+    class Finder {
+    public:
+        enum class Kind { None, Byte, Substring, Literals, ByteSet };
+
+        Finder() = default;
+
+        // 优先使用字面量；没有字面量时退回NFA起始闭包上的首字节集合
+        Finder(const std::vector<std::string> &prefixes, const DataStructures::CompactAutomaton &nfa, int start_state) {
+            bool single_bytes = std::all_of(prefixes.begin(), prefixes.end(), [](const std::string &p) { return p.size() == 1; });
+            if (prefixes.size() == 1) {
+                literals = prefixes;
+                kind = prefixes[0].size() == 1 ? Kind::Byte : Kind::Substring;
+            } else if (!prefixes.empty() && single_bytes) {
+                for (const auto &prefix : prefixes) first_byte[(unsigned char)prefix[0]] = true;
+                byte_count = prefixes.size();
+                kind = Kind::ByteSet;
+            } else if (!prefixes.empty()) {
+                build_buckets(prefixes);
+            } else {
+                build_byte_set(nfa, start_state);
+            }
+        }
+
+        Kind type() const { return kind; }
+        void disable() { kind = Kind::None; }
+
+        std::string describe() const {
+            std::ostringstream oss;
+            switch (kind) {
+                case Kind::None: return "none";
+                case Kind::Byte: oss << "memchr '" << DataStructures::range_label(literals[0][0], literals[0][0]) << "'"; break;
+                case Kind::Substring: oss << "substring \"" << literals[0] << "\""; break;
+                case Kind::Literals: {
+                    oss << literals.size() << " literals (";
+                    for (size_t i = 0; i < literals.size(); i++) oss << (i ? ", \"" : "\"") << literals[i] << "\"";
+                    oss << ")";
+                    break;
+                }
+                case Kind::ByteSet: oss << "first-byte set (" << byte_count << " bytes)"; break;
+            }
+            return oss.str();
+        }
+
+        // 返回 [from, size) 中第一个可能开始匹配的位置，没有时返回 size。
+        // 末尾放不下最长字面量的位置可能在后续输入中补全，一律视为候选
+        size_t find(const std::string &text, size_t from) const {
+            const char *data = text.data();
+            size_t size = text.size();
+            if (from >= size) return size;
+            switch (kind) {
+                case Kind::None:
+                    return from;
+                case Kind::Byte: {
+                    const void *hit = std::memchr(data + from, (unsigned char)literals[0][0], size - from);
+                    return hit ? (const char *)hit - data : size;
+                }
+                case Kind::Substring: {
+                    const std::string &needle = literals[0];
+                    size_t tail = size >= needle.size() ? size - needle.size() + 1 : 0;
+                    if (from < tail) {
+                        const void *hit = memmem(data + from, size - from, needle.data(), needle.size());
+                        if (hit) return (const char *)hit - data;
+                    }
+                    return std::max(from, tail);
+                }
+                case Kind::Literals:
+                    return find_literals(data, from, size);
+                case Kind::ByteSet: {
+                    const unsigned char *bytes = (const unsigned char *)data;
+                    size_t position = from;
+                    while (position < size && !first_byte[bytes[position]]) position++;
+                    return position;
+                }
+            }
+            return from;
+        }
+
+    private:
+        Kind kind = Kind::None;
+        std::vector<std::string> literals;
+        // 字面量分成8个桶；第 k 位表示桶 k 中有字面量的第1（第2）个字节为该值，长度为1的字面量对第2个字节不设限制
+        std::array<uint8_t, 256> first_mask{};
+        std::array<uint8_t, 256> second_mask{};
+        std::array<std::vector<int>, 8> buckets;
+        size_t longest = 0;
+        std::array<bool, 256> first_byte{};
+        int byte_count = 0;
+
+        void build_buckets(const std::vector<std::string> &prefixes) {
+            kind = Kind::Literals;
+            literals = prefixes;
+            for (size_t i = 0; i < literals.size(); i++) {
+                const std::string &literal = literals[i];
+                int bucket = i % 8;
+                buckets[bucket].push_back(i);
+                first_mask[(unsigned char)literal[0]] |= 1 << bucket;
+                if (literal.size() == 1) {
+                    for (auto &mask : second_mask) mask |= 1 << bucket;
+                } else {
+                    second_mask[(unsigned char)literal[1]] |= 1 << bucket;
+                }
+                longest = std::max(longest, literal.size());
+            }
+        }
+
+        void build_byte_set(const DataStructures::CompactAutomaton &nfa, int start_state) {
+            std::vector<char> visited(nfa.state_count, 0);
+            std::vector<int> stack = {start_state};
+            while (!stack.empty()) {
+                int state = stack.back();
+                stack.pop_back();
+                if (visited[state]) continue;
+                visited[state] = 1;
+                if (nfa.accept_states[state]) return; // 可匹配空串
+                for (int k = nfa.transition_offsets[state]; k < nfa.transition_offsets[state + 1]; k++) {
+                    for (int byte = nfa.transition_lo[k]; byte <= nfa.transition_hi[k]; byte++) first_byte[byte] = true;
+                }
+                for (int k = nfa.epsilon_offsets[state]; k < nfa.epsilon_offsets[state + 1]; k++) {
+                    stack.push_back(nfa.epsilon_targets[k]);
+                }
+            }
+            byte_count = std::count(first_byte.begin(), first_byte.end(), true);
+            if (byte_count <= MAX_SKIP_BYTES) kind = Kind::ByteSet;
+        }
+
+        // 按相邻两个字节的桶掩码筛出候选位置（Teddy的指纹思路，用查表代替向量混洗），再逐个比较桶内字面量
+        size_t find_literals(const char *data, size_t from, size_t size) const {
+            const unsigned char *bytes = (const unsigned char *)data;
+            size_t tail = size >= longest ? size - longest + 1 : 0;
+            for (size_t position = from; position < tail; position++) {
+                uint8_t second = position + 1 < size ? second_mask[bytes[position + 1]] : 0xFF;
+                uint8_t candidates = first_mask[bytes[position]] & second;
+                for (int bucket = 0; candidates; bucket++, candidates >>= 1) {
+                    if (!(candidates & 1)) continue;
+                    for (int index : buckets[bucket]) {
+                        const std::string &literal = literals[index];
+                        if (std::memcmp(data + position, literal.data(), literal.size()) == 0) return position;
+                    }
+                }
+            }
+            return std::max(from, tail);
+        }
+    };
+}
+
+namespace StreamSearch {
+    const int MAX_CACHED_STATES = 1024;
+    const int UNKNOWN = -1;
+
+    // 沿ε转移求闭包，seen 中已有的状态（更早的线程组已占用）不再加入
+    void closure_into(const DataStructures::CompactAutomaton &automaton, DFAConverter::SparseSet &seen,
+                      std::vector<int> &stack, std::vector<int> &out) {
+        while (!stack.empty()) {
+            int state = stack.back();
+            stack.pop_back();
+            if (seen.contains(state)) continue;
+            seen.insert(state);
+            out.push_back(state);
+            for (int k = automaton.epsilon_offsets[state]; k < automaton.epsilon_offsets[state + 1]; k++) {
+                stack.push_back(automaton.epsilon_targets[k]);
+            }
+        }
+    }
+
+    void move_into(const DataStructures::CompactAutomaton &automaton, const std::vector<int> &states,
+                   unsigned char byte, std::vector<int> &stack) {
+        for (int state : states) {
+            for (int k = automaton.transition_offsets[state]; k < automaton.transition_offsets[state + 1]; k++) {
+                if (automaton.accepts_byte(k, byte)) {
+                    stack.push_back(automaton.transition_targets[k]);
+                }
+            }
+        }
+    }
+
+    // 前向DFA状态：groups[i] 为第 i 早的起点上仍存活的NFA状态（各组互不相交）。
+    // 某组到达接受状态后，比它晚的组全部丢弃且不再开启新起点（flagged），该组即为当前候选匹配，
+    // 候选组死亡后保留为空组，直到更早的组匹配或全部死亡
+    struct ForwardState {
+        std::vector<std::vector<int>> groups;
+        bool flagged;    // 最后一组为候选匹配
+        bool accepting;  // 候选组在当前位置接受：记录匹配终点
+        bool fresh;      // 只剩当前位置新开启的起点，更早的输入不再需要
+        bool done;       // 候选组已是最早的组且已死亡：匹配确定
+        std::vector<int> next;
+    };
+
+    class ForwardDFA {
+    public:
+        ForwardDFA(const DataStructures::CompactAutomaton &automaton, int start_state)
+            : nfa(automaton), start(start_state), seen(automaton.state_count) {
+            rebuild();
+        }
+
+        int initial_state() const { return initial; }
+        int no_start_state() const { return no_start; }
+        const ForwardState &state(int id) const { return states[id]; }
+
+        int step(int &current, unsigned char byte) {
+            if (states[current].next[byte] != UNKNOWN) return states[current].next[byte];
+
+            if ((int)states.size() >= MAX_CACHED_STATES) {
+                ForwardState saved = states[current];
+                rebuild();
+                current = intern(saved.groups, saved.flagged, saved.accepting, saved.fresh);
+            }
+
+            const ForwardState &from = states[current];
+            bool flagged = from.flagged;
+            std::vector<std::vector<int>> groups;
+            seen.clear();
+            for (size_t i = 0; i < from.groups.size(); i++) {
+                std::vector<int> out;
+                move_into(nfa, states[current].groups[i], byte, stack);
+                closure_into(nfa, seen, stack, out);
+                bool candidate = flagged && i + 1 == states[current].groups.size();
+                if (!out.empty() || candidate) groups.push_back(std::move(out));
+            }
+
+            int target = finish_state(std::move(groups), flagged);
+            states[current].next[byte] = target;
+            return target;
+        }
+
+    private:
+        const DataStructures::CompactAutomaton &nfa;
+        int start;
+        int initial = 0;
+        int no_start = 0;
+        std::vector<ForwardState> states;
+        std::unordered_map<std::vector<int>, int, DFAConverter::StateSetHash> index;
+        DFAConverter::SparseSet seen;
+        std::vector<int> stack;
+
+        void rebuild() {
+            states.clear();
+            index.clear();
+            seen.clear();
+            no_start = intern({}, false, false, false);
+            initial = finish_state({}, false);
+        }
+
+        // 未出现候选匹配时在当前位置开启新起点，再按起点先后检查接受状态
+        int finish_state(std::vector<std::vector<int>> groups, bool flagged) {
+            bool fresh = false;
+            if (!flagged) {
+                std::vector<int> out;
+                stack.push_back(start);
+                closure_into(nfa, seen, stack, out);
+                if (!out.empty()) {
+                    fresh = groups.empty();
+                    groups.push_back(std::move(out));
+                }
+            }
+
+            bool accepting = false;
+            for (size_t i = 0; i < groups.size() && !accepting; i++) {
+                for (int state : groups[i]) {
+                    if (!nfa.accept_states[state]) continue;
+                    groups.resize(i + 1);
+                    flagged = accepting = true;
+                    break;
+                }
+            }
+
+            for (auto &group : groups) std::sort(group.begin(), group.end());
+            return intern(groups, flagged, accepting, fresh);
+        }
+
+        int intern(const std::vector<std::vector<int>> &groups, bool flagged, bool accepting, bool fresh) {
+            std::vector<int> key;
+            for (const auto &group : groups) {
+                key.insert(key.end(), group.begin(), group.end());
+                key.push_back(-1);
+            }
+            key.push_back(flagged);
+            key.push_back(accepting);
+            key.push_back(fresh);
+
+            auto it = index.find(key);
+            if (it != index.end()) return it->second;
+
+            int id = states.size();
+            bool done = flagged && groups.size() == 1 && groups[0].empty();
+            states.push_back({groups, flagged, accepting, fresh, done, std::vector<int>(256, UNKNOWN)});
+            index.emplace(std::move(key), id);
+            return id;
+        }
+    };
+
+    // 反向DFA：在反转的NFA上从所有接受状态出发，到达原起始状态即为一个匹配起点
+    class ReverseDFA {
+    public:
+        ReverseDFA(const DataStructures::CompactAutomaton &forward, int start_state)
+            : target(start_state), seen(forward.state_count) {
+            for (int state = 0; state < forward.state_count; state++) reversed.add_state();
+            for (int state = 0; state < forward.state_count; state++) {
+                for (int k = forward.transition_offsets[state]; k < forward.transition_offsets[state + 1]; k++) {
+                    reversed.add_transition(forward.transition_targets[k], forward.transition_lo[k],
+                                            forward.transition_hi[k], state);
+                }
+                for (int k = forward.epsilon_offsets[state]; k < forward.epsilon_offsets[state + 1]; k++) {
+                    reversed.add_epsilon(forward.epsilon_targets[k], state);
+                }
+                if (forward.accept_states[state]) accept_seeds.push_back(state);
+            }
+            reversed.finalize();
+            rebuild();
+        }
+
+        // 从 end 向前扫描到 lower_bound，返回最长反向匹配的起点（不存在时为 -1）
+        long long longest_start(const std::string &text, size_t lower_bound, size_t end) {
+            int current = initial;
+            long long best = states[current].accept ? (long long)end : -1;
+            for (size_t position = end; position > lower_bound; position--) {
+                current = step(current, (unsigned char)text[position - 1]);
+                if (states[current].nfa_states.empty()) break;
+                if (states[current].accept) best = position - 1;
+            }
+            return best;
+        }
+
+    private:
+        struct CachedState {
+            std::vector<int> nfa_states;
+            bool accept;
+            std::vector<int> next;
+        };
+
+        DataStructures::CompactAutomaton reversed;
+        std::vector<int> accept_seeds;
+        int target;
+        int initial = 0;
+        std::vector<CachedState> states;
+        std::unordered_map<std::vector<int>, int, DFAConverter::StateSetHash> index;
+        DFAConverter::SparseSet seen;
+        std::vector<int> stack;
+
+        void rebuild() {
+            states.clear();
+            index.clear();
+            seen.clear();
+            std::vector<int> out;
+            stack = accept_seeds;
+            closure_into(reversed, seen, stack, out);
+            initial = intern(std::move(out));
+        }
+
+        int step(int current, unsigned char byte) {
+            if (states[current].next[byte] != UNKNOWN) return states[current].next[byte];
+
+            if ((int)states.size() >= MAX_CACHED_STATES) {
+                std::vector<int> saved = states[current].nfa_states;
+                rebuild();
+                current = intern(std::move(saved));
+            }
+
+            std::vector<int> out;
+            seen.clear();
+            move_into(reversed, states[current].nfa_states, byte, stack);
+            closure_into(reversed, seen, stack, out);
+            int next = intern(std::move(out));
+            states[current].next[byte] = next;
+            return next;
+        }
+
+        int intern(std::vector<int> nfa_states) {
+            std::sort(nfa_states.begin(), nfa_states.end());
+            auto it = index.find(nfa_states);
+            if (it != index.end()) return it->second;
+
+            int id = states.size();
+            bool accept = std::binary_search(nfa_states.begin(), nfa_states.end(), target);
+            index.emplace(nfa_states, id);
+            states.push_back({std::move(nfa_states), accept, std::vector<int>(256, UNKNOWN)});
+            return id;
+        }
+    };
+}
+
+// 多模式匹配模块 - 所有模式共用一个NFA（新起始状态经ε转移到各模式），
+// 按需确定化得到乘积DFA，每个DFA状态带有其包含的接受状态所属模式的位集
+namespace PatternSet {
+    const int MAX_CACHED_STATES = 4096;
+    const int UNKNOWN = -1;
+
+    struct CachedState {
+        std::vector<int> nfa_states;
+        std::vector<uint64_t> patterns; // 第 i 位：模式 i 在此状态接受
+        std::vector<int> next;
+    };
+
+    class ProductDFA {
+    public:
+        ProductDFA(DataStructures::CompactAutomaton automaton, int start_state, std::vector<int> pattern_of_accept,
+                   int pattern_count)
+            : nfa(std::move(automaton)), start(start_state), pattern_of(std::move(pattern_of_accept)),
+              words((pattern_count + 63) / 64), seen(nfa.state_count) {
+            rebuild();
+        }
+
+        // 一次扫描整个输入，返回接受状态的模式位集（所有模式都已死亡时提前结束）
+        const std::vector<uint64_t> &run(const std::string &input) {
+            int current = initial;
+            for (unsigned char byte : input) {
+                current = step(current, byte);
+                if (current == dead) break;
+            }
+            return states[current].patterns;
+        }
+
+        size_t cached_states() const { return states.size(); }
+        int nfa_states() const { return nfa.state_count; }
+
+    private:
+        DataStructures::CompactAutomaton nfa;
+        int start;
+        std::vector<int> pattern_of;    // NFA接受状态所属的模式，非接受状态为 -1
+        size_t words;
+        int initial = 0;
+        int dead = 0;
+        std::vector<CachedState> states;
+        std::unordered_map<std::vector<int>, int, DFAConverter::StateSetHash> index;
+        DFAConverter::SparseSet seen;
+        std::vector<int> stack;
+
+        void rebuild() {
+            states.clear();
+            index.clear();
+            dead = intern({});
+            std::vector<int> out;
+            seen.clear();
+            stack.push_back(start);
+            StreamSearch::closure_into(nfa, seen, stack, out);
+            initial = intern(std::move(out));
+        }
+
+        int step(int current, unsigned char byte) {
+            if (states[current].next[byte] != UNKNOWN) return states[current].next[byte];
+
+            if ((int)states.size() >= MAX_CACHED_STATES) {
+                std::vector<int> saved = states[current].nfa_states;
+                rebuild();
+                current = intern(std::move(saved));
+            }
+
+            std::vector<int> out;
+            seen.clear();
+            StreamSearch::move_into(nfa, states[current].nfa_states, byte, stack);
+            StreamSearch::closure_into(nfa, seen, stack, out);
+            int next = intern(std::move(out));
+            states[current].next[byte] = next;
+            return next;
+        }
+
+        int intern(std::vector<int> nfa_states) {
+            std::sort(nfa_states.begin(), nfa_states.end());
+            auto it = index.find(nfa_states);
+            if (it != index.end()) return it->second;
+
+            std::vector<uint64_t> patterns(words, 0);
+            for (int state : nfa_states) {
+                int pattern = pattern_of[state];
+                if (pattern >= 0) patterns[pattern / 64] |= uint64_t(1) << (pattern % 64);
+            }
+
+            int id = states.size();
+            index.emplace(nfa_states, id);
+            states.push_back({std::move(nfa_states), std::move(patterns), std::vector<int>(256, UNKNOWN)});
+            return id;
         }
-        
-        out << "}\n";
-        out.close();
-    }
+    };
 }
 
 // API接口命名空间 - 用于web后端集成
@@ -645,16 +3709,31 @@ namespace RegexBuilder {
     static std::string currentRegex;
     static std::string nfaDescription;
     static std::string dfaDescription;
+    static bool lazyMode = false; // 完整DFA过大，匹配使用惰性DFA
+    static bool countingMode = false; // NFA含计数器，不构建DFA，匹配使用计数模拟
+    static bool dfaBuilt = false;  // DFA在第一次需要时才构建
+    static RegexAutomata::Construction construction = RegexAutomata::Construction::Thompson;
+    static std::string constructionStats; // Glushkov模式下与Thompson路径的子集构造对比
+    static int nfaStartState = 0;
+    static std::string lastMatchEngine;
+    static std::string lastError;  // 最近一次编译失败的原因
+    static std::vector<std::string> searchPrefixes; // 搜索预过滤用的必需前缀字面量
+    static bool taggedBuilt = false; // 带标签的DFA在第一次提取捕获组时才构建
+    static std::string taggedDescription;
+    
+    // 自动选择引擎时，输入长度 × NFA状态数不超过该值且DFA尚未构建，则直接用Pike VM，省去DFA构建
+    const long long PIKE_VM_STEP_BUDGET = 1 << 20;
+    
+    // DFA超过该状态数时描述中不逐条列出转移，也不生成DOT（图太大，无法渲染）
+    const int MAX_VISUALIZED_STATES = 4096;
     
     // 重置所有状态
     void resetState() {
-        DataStructures::nfa_states.clear();
-        DataStructures::dfa_states.clear();
+        DataStructures::nfa.clear();
+        DataStructures::dfa.clear();
         while (!DataStructures::state_stack.empty()) {
             DataStructures::state_stack.pop();
         }
-        DataStructures::alphabet.clear();
-        NFAConstructor::state_index = 0;
         NFAManager::states.clear();
         NFAManager::non_initial_states.clear();
         NFAManager::accept_states.clear();
@@ -665,55 +3744,169 @@ namespace RegexBuilder {
         DFAMinimizer::state_partition.clear();
         DFAMinimizer::partitions.clear();
         DFAMinimizer::minimized_transitions.clear();
+        DenseDFA::compiled = DenseDFA::Table();
+        BitParallel::compiled = BitParallel::Matcher();
+        LazyDFA::reset(0);
+        TaggedDFA::compiled = TaggedDFA::Table();
+        taggedBuilt = false;
+        taggedDescription.clear();
+        lazyMode = false;
+        countingMode = false;
+        dfaBuilt = false;
+        construction = RegexAutomata::Construction::Thompson;
+        constructionStats.clear();
+        nfaStartState = 0;
+        lastMatchEngine.clear();
         isInitialized = false;
         currentRegex.clear();
+        lastError.clear();
+        searchPrefixes.clear();
         nfaDescription.clear();
         dfaDescription.clear();
     }
     
     // 生成NFA和DFA的描述信息
-    void generateDescriptions();
+    void generateNFADescription();
+    void generateDFADescription();
+    bool buildDerivativeDFA(const std::string& regex, bool& canFallBack);
+    
+    // 把一个正则表达式编译为 DataStructures::nfa 中的一个片段（追加状态，不清空已有内容）；
+    // 语法错误时记录到 lastError 并返回 false
+    // allowCounters 为 false 时大边界的计数重复也完全展开（供只认识普通NFA的引擎使用）
+    // optimizedAst 非空时返回优化后的语法树
+    bool compilePattern(const std::string& regex, int& start_state, int& final_state, bool allowCounters = true,
+                        RegexParser::NodePtr* optimizedAst = nullptr) {
+        while (!DataStructures::state_stack.empty()) {
+            DataStructures::state_stack.pop();
+        }
+        
+        NFAConstructor::allow_counters = allowCounters;
+        try {
+            // 1. 语法分析，生成抽象语法树
+            RegexParser::Parser parser(regex);
+            RegexParser::NodePtr ast = parser.parse();
+            
+            // 2. 语法树优化
+            ast = RegexOptimizer::optimize(ast);
+            if (optimizedAst) *optimizedAst = ast;
+            
+            // 3. Thompson构造
+            NFAConstructor::capture_group_count = parser.group_count();
+            NFAConstructor::build_nfa_from_ast(ast);
+        } catch (const std::runtime_error& e) {
+            lastError = e.what();
+            return false;
+        }
+        
+        final_state = DataStructures::state_stack.top();
+        DataStructures::state_stack.pop();
+        start_state = DataStructures::state_stack.top();
+        DataStructures::state_stack.pop();
+        return true;
+    }
+    
+    // 把多个模式编译进同一个NFA（计数重复完全展开）；借用全局构建流程，完成后恢复当前正则表达式的状态。
+    // 返回第一个无法编译的模式下标，全部成功时返回 -1
+    int compilePatternSet(const std::vector<std::string>& patterns, DataStructures::CompactAutomaton& automaton,
+                          int& start_state, std::vector<int>& pattern_of_accept) {
+        int savedGroupCount = NFAConstructor::capture_group_count;
+        automaton.clear();
+        std::swap(DataStructures::nfa, automaton);
+        
+        int failed = -1;
+        std::vector<std::pair<int, int>> fragments;
+        for (size_t i = 0; i < patterns.size() && failed < 0; i++) {
+            int start = 0, final = 0;
+            if (compilePattern(patterns[i], start, final, false)) {
+                fragments.push_back({start, final});
+            } else {
+                failed = i;
+            }
+        }
+        
+        if (failed < 0) {
+            start_state = DataStructures::nfa.add_state();
+            for (const auto& [start, final] : fragments) {
+                DataStructures::nfa.add_epsilon(start_state, start);
+                DataStructures::nfa.accept_states[final] = 1;
+            }
+            pattern_of_accept.assign(DataStructures::nfa.state_count, -1);
+            for (size_t i = 0; i < fragments.size(); i++) {
+                pattern_of_accept[fragments[i].second] = i;
+            }
+            DataStructures::nfa.finalize();
+        }
+        
+        std::swap(DataStructures::nfa, automaton);
+        NFAConstructor::capture_group_count = savedGroupCount;
+        return failed;
+    }
+    
+    // 用Glushkov构造编译到全局NFA（接受状态由构造给出），失败时记录原因并返回 false
+    bool compileGlushkov(const std::string& regex, int& start_state, RegexParser::NodePtr& ast) {
+        try {
+            RegexParser::Parser parser(regex);
+            ast = RegexOptimizer::optimize(parser.parse());
+            NFAConstructor::capture_group_count = parser.group_count();
+            start_state = GlushkovConstructor::build(ast, DataStructures::nfa);
+        } catch (const std::runtime_error& e) {
+            lastError = e.what();
+            return false;
+        }
+        return true;
+    }
     
     // 从正则表达式构建自动机
-    bool buildAutomataFromRegex(const std::string& regex) {
+    bool buildAutomataFromRegex(const std::string& regex, RegexAutomata::Construction mode) {
         try {
             resetState();
             currentRegex = regex;
+            construction = mode;
             
-            // 1. 输入验证
-            InputValidator::validate_input(regex);
-            
-            // 2. 预处理正则表达式
-            std::string processed_regex = RegexPreprocessor::add_concatenation(regex);
-            
-            // 3. 转换为后缀表达式
-            std::string postfix = RegexConverter::infix_to_postfix(processed_regex);
+            std::string fallbackNote;
+            if (mode == RegexAutomata::Construction::Derivative) {
+                bool canFallBack = false;
+                if (buildDerivativeDFA(regex, canFallBack)) {
+                    nfaDescription = "NFA not built: the derivative construction goes straight to a DFA\n";
+                    generateDFADescription();
+                    dfaBuilt = true;
+                    isInitialized = true;
+                    return true;
+                }
+                if (!canFallBack) return false;
+                
+                // 没有 & 和 ~ 时，导数构造失败改用Thompson构造（子集构造与最小化可以处理更多状态）
+                fallbackNote = "Derivative construction failed (" + lastError + "), fell back to thompson\n";
+                resetState();
+                currentRegex = regex;
+                mode = RegexAutomata::Construction::Thompson;
+                construction = mode;
+            }
             
-            // 4. 构建NFA
-            NFAConstructor::build_nfa_from_postfix(postfix);
+            // 语法分析并构建NFA
+            int start_state = 0, final_state = 0;
+            RegexParser::NodePtr ast;
+            bool compiled = mode == RegexAutomata::Construction::Glushkov
+                ? compileGlushkov(regex, start_state, ast)
+                : compilePattern(regex, start_state, final_state, true, &ast);
             
-            // 5. 设置最终状态
-            if (DataStructures::state_stack.size() >= 2) {
-                int final_state = DataStructures::state_stack.top(); 
-                DataStructures::state_stack.pop();
-                int start_state = DataStructures::state_stack.top(); 
-                DataStructures::state_stack.pop();
-                
-                DataStructures::nfa_states[final_state].accept_state = true;
+            // 设置最终状态
+            if (compiled) {
+                if (mode == RegexAutomata::Construction::Thompson) DataStructures::nfa.accept_states[final_state] = 1;
+                DataStructures::nfa.finalize();
                 
                 // 初始化NFA管理器（现在接受状态已经设置好了）
-                NFAManager::initialize();
-                
-                // 6. 转换为DFA
-                DFAConverter::convert_nfa_to_dfa(start_state, DataStructures::nfa_states.size());
-                DFAManager::initialize();
-                
-                // 7. 最小化DFA
-                DFAMinimizer::minimize_dfa();
-                
-                // 8. 生成描述信息
-                generateDescriptions();
+                NFAManager::initialize(start_state);
+                nfaStartState = start_state;
+                countingMode = !DataStructures::nfa.counters.empty();
+                BitParallel::compile(ast);
+                searchPrefixes = Prefilter::required_prefixes(ast);
+                constructionStats = fallbackNote;
+                std::cout << "AST optimization: " << RegexOptimizer::last_report.front().before.states << " -> "
+                          << RegexOptimizer::last_report.back().after.states << " NFA states\n";
+                generateNFADescription();
                 
+                // DFA的构建推迟到第一次需要时（ensureDFA）
                 isInitialized = true;
                 return true;
             }
@@ -725,52 +3918,276 @@ namespace RegexBuilder {
         }
     }
     
+    // 构建DFA（子集构造、最小化、稠密表）；状态数超限时不再构建完整DFA，匹配时按需确定化
+    // 子集构造并计时；返回DFA状态数，超过上限时返回 -1
+    int timedSubsetConstruction(int start_state, double& milliseconds) {
+        auto begin = std::chrono::steady_clock::now();
+        bool built = DFAConverter::convert_nfa_to_dfa(start_state, DataStructures::nfa.state_count);
+        auto end = std::chrono::steady_clock::now();
+        milliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+        return built ? DataStructures::dfa.state_count : -1;
+    }
+    
+    void appendSubsetStats(std::ostringstream& oss, const std::string& name, int dfaStates, double milliseconds) {
+        const DataStructures::CompactAutomaton& nfa = DataStructures::nfa;
+        oss << "Subset construction (" << name << "): " << nfa.state_count << " NFA states, "
+            << nfa.transition_targets.size() << " transitions, " << nfa.epsilon_targets.size() << " ε-edges -> ";
+        if (dfaStates < 0) oss << "too many DFA states (limit " << DFAConverter::max_dfa_transitions << " transitions)";
+        else oss << dfaStates << " DFA states";
+        oss << " in " << milliseconds << " ms\n";
+    }
+    
+    // Glushkov模式：先在同一正则表达式的Thompson NFA上做一次子集构造作为对比，再构造本模式的DFA
+    bool buildGlushkovDFAWithComparison() {
+        std::ostringstream stats;
+        DataStructures::CompactAutomaton thompson;
+        int thompsonStart = 0;
+        std::vector<int> patternOfAccept;
+        if (compilePatternSet({currentRegex}, thompson, thompsonStart, patternOfAccept) < 0) {
+            std::swap(DataStructures::nfa, thompson);
+            double milliseconds = 0;
+            int dfaStates = timedSubsetConstruction(thompsonStart, milliseconds);
+            appendSubsetStats(stats, "thompson", dfaStates, milliseconds);
+            std::swap(DataStructures::nfa, thompson);
+        }
+        
+        double milliseconds = 0;
+        int dfaStates = timedSubsetConstruction(nfaStartState, milliseconds);
+        appendSubsetStats(stats, "glushkov", dfaStates, milliseconds);
+        constructionStats = stats.str();
+        return dfaStates >= 0;
+    }
+    
+    // 导数构造：不构建NFA，直接从语法树得到DFA；正则表达式不含 & 和 ~ 时附带Thompson路径的子集构造对比。
+    // 构造本身失败（状态数、重复上界超限）且不含 & 和 ~ 时 canFallBack 为 true，可改用Thompson构造
+    bool buildDerivativeDFA(const std::string& regex, bool& canFallBack) {
+        canFallBack = false;
+        RegexParser::NodePtr ast;
+        try {
+            RegexParser::Parser parser(regex, true);
+            ast = parser.parse();
+            NFAConstructor::capture_group_count = parser.group_count();
+        } catch (const std::runtime_error& e) {
+            lastError = e.what();
+            return false;
+        }
+        searchPrefixes = Prefilter::required_prefixes(ast);
+        
+        std::ostringstream stats;
+        DataStructures::CompactAutomaton thompson;
+        int thompsonStart = 0;
+        std::vector<int> patternOfAccept;
+        if (compilePatternSet({regex}, thompson, thompsonStart, patternOfAccept) < 0) {
+            std::swap(DataStructures::nfa, thompson);
+            double milliseconds = 0;
+            int dfaStates = timedSubsetConstruction(thompsonStart, milliseconds);
+            appendSubsetStats(stats, "thompson", dfaStates, milliseconds);
+            std::swap(DataStructures::nfa, thompson);
+        }
+        lastError.clear();
+        
+        try {
+            auto begin = std::chrono::steady_clock::now();
+            DerivativeDFA::build(ast, DFAConverter::max_dfa_transitions);
+            auto end = std::chrono::steady_clock::now();
+            stats << "Derivative construction: " << DerivativeDFA::explored_terms << " terms -> "
+                  << DataStructures::dfa.state_count << " DFA states in "
+                  << std::chrono::duration<double, std::milli>(end - begin).count() << " ms\n";
+        } catch (const std::runtime_error& e) {
+            lastError = e.what();
+            canFallBack = !DerivativeDFA::uses_boolean_operators(ast);
+            return false;
+        }
+        
+        DFAManager::initialize();
+        DFAMinimizer::minimize_dfa();
+        DenseDFA::compile();
+        stats << "Derivative DFA after minimization: " << DFAMinimizer::partitions.size() << " states\n";
+        constructionStats = stats.str();
+        return true;
+    }
+    
+    void ensureDFA() {
+        if (!isInitialized || dfaBuilt) return;
+        
+        if (countingMode) {
+            // 计数器无法确定化，不构建DFA
+        } else if (construction == RegexAutomata::Construction::Glushkov
+                       ? buildGlushkovDFAWithComparison()
+                       : DFAConverter::convert_nfa_to_dfa(nfaStartState, DataStructures::nfa.state_count)) {
+            DFAManager::initialize();
+            DFAMinimizer::minimize_dfa();
+            DenseDFA::compile();
+        } else {
+            lazyMode = true;
+            LazyDFA::reset(nfaStartState);
+        }
+        
+        generateDFADescription();
+        dfaBuilt = true;
+    }
+    
     // 匹配字符串
-    bool matchString(const std::string& input) {
+    bool matchString(const std::string& input, RegexAutomata::MatchEngine engine) {
         if (!isInitialized) {
             return false;
         }
         
         try {
-            int current_state = DFAMinimizer::state_partition[0]; // 初始状态的分区
-            
-            for (char c : input) {
-                bool found_transition = false;
-                
-                // 在最小化的转移关系中查找
-                for (const auto& [from, symbol, to] : DFAMinimizer::minimized_transitions) {
-                    if (from == current_state && symbol == c) {
-                        current_state = to;
-                        found_transition = true;
-                        break;
-                    }
-                }
-                
-                if (!found_transition) {
-                    return false; // 没有找到转移，拒绝
+            if (construction == RegexAutomata::Construction::Derivative) {
+                // 没有NFA，任何引擎都用DFA
+                engine = RegexAutomata::MatchEngine::DFA;
+            } else if (engine == RegexAutomata::MatchEngine::Auto || engine == RegexAutomata::MatchEngine::BitParallel) {
+                if (BitParallel::compiled.ready) {
+                    lastMatchEngine = "bitparallel";
+                    return BitParallel::match(BitParallel::compiled, input);
                 }
+                engine = RegexAutomata::MatchEngine::Auto;
             }
             
-            // 检查最终状态是否为接受状态
-            for (const auto& accept_state : DFAManager::accept_states) {
-                if (DFAMinimizer::state_partition[accept_state] == current_state) {
-                    return true;
-                }
+            if (countingMode) {
+                lastMatchEngine = "counting";
+                return CountingNFA::match(DataStructures::nfa, nfaStartState, input);
             }
             
-            return false;
+            if (engine == RegexAutomata::MatchEngine::Auto) {
+                bool smallInput = (long long)input.size() * DataStructures::nfa.state_count <= PIKE_VM_STEP_BUDGET;
+                engine = (!dfaBuilt && smallInput) ? RegexAutomata::MatchEngine::PikeVM : RegexAutomata::MatchEngine::DFA;
+            }
+            
+            if (engine == RegexAutomata::MatchEngine::PikeVM) {
+                lastMatchEngine = "pikevm";
+                std::vector<std::pair<int, int>> groups;
+                return PikeVM::match(nfaStartState, NFAConstructor::capture_group_count, input, groups);
+            }
             
+            ensureDFA();
+            if (lazyMode) {
+                lastMatchEngine = "lazy-dfa";
+                return LazyDFA::match(input);
+            }
+            lastMatchEngine = "dfa";
+            return DenseDFA::match(DenseDFA::compiled, input);
         } catch (const std::exception& e) {
             return false;
         }
     }
     
-    // 生成NFA和DFA的描述信息
-    void generateDescriptions() {
+    // 构建带标签的DFA并记录统计；状态数或寄存器操作数超限时不可用，提取捕获组退回Pike VM
+    void ensureTaggedDFA() {
+        if (!isInitialized || taggedBuilt) return;
+        
+        std::ostringstream oss;
+        auto begin = std::chrono::steady_clock::now();
+        bool built = TaggedDFA::build(DataStructures::nfa, nfaStartState, NFAConstructor::capture_group_count,
+                                      DFAConverter::max_dfa_transitions);
+        auto end = std::chrono::steady_clock::now();
+        const TaggedDFA::Table& table = TaggedDFA::compiled;
+        if (built) {
+            oss << "Tagged DFA: " << table.state_count << " states x " << table.class_count << " byte classes, "
+                << table.register_count << " registers, " << table.operations.size()
+                << " register operations, built in " << std::chrono::duration<double, std::milli>(end - begin).count()
+                << " ms\n";
+        } else {
+            oss << "Tagged DFA: not built (more than " << DFAConverter::max_dfa_transitions << " transitions or "
+                << TaggedDFA::MAX_OPERATIONS << " register operations), captures use the Pike VM\n";
+        }
+        taggedDescription = oss.str();
+        taggedBuilt = true;
+    }
+    
+    // 带捕获组的匹配；计数模式、Glushkov模式（NFA中没有捕获标记）和导数模式下只给出整体匹配。
+    // preferTagged 为 false 时，带标签的DFA尚未构建且输入较短则直接用Pike VM，省去构建
+    bool matchWithCaptures(const std::string& input, std::vector<std::pair<int, int>>& groups, bool preferTagged = false) {
+        groups.clear();
+        if (!isInitialized) {
+            return false;
+        }
+        if (countingMode || construction != RegexAutomata::Construction::Thompson ||
+            NFAConstructor::capture_group_count == 0) {
+            if (!RegexBuilder::matchString(input, RegexAutomata::MatchEngine::Auto)) return false;
+            groups.assign(NFAConstructor::capture_group_count + 1, {-1, -1});
+            groups[0] = {0, (int)input.size()};
+            return true;
+        }
+        
+        bool smallInput = (long long)input.size() * DataStructures::nfa.state_count <= PIKE_VM_STEP_BUDGET;
+        if (preferTagged || taggedBuilt || !smallInput) {
+            ensureTaggedDFA();
+            if (TaggedDFA::compiled.ready) {
+                lastMatchEngine = "tagged-dfa";
+                return TaggedDFA::match(TaggedDFA::compiled, input, groups);
+            }
+        }
+        lastMatchEngine = "pikevm";
+        return PikeVM::match(nfaStartState, NFAConstructor::capture_group_count, input, groups);
+    }
+    
+    std::string getTaggedDFADescription() {
+        return taggedDescription;
+    }
+    
+    // 批量匹配：有完整DFA时交错匹配，否则（惰性DFA、计数模式）逐个按 Auto 匹配
+    std::vector<uint64_t> matchBatch(const std::vector<std::string>& inputs) {
+        std::vector<uint64_t> verdicts((inputs.size() + 63) / 64, 0);
+        if (!isInitialized) {
+            return verdicts;
+        }
+        
+        try {
+            ensureDFA();
+            if (!lazyMode && !countingMode) {
+                lastMatchEngine = "dfa";
+                DenseDFA::match_batch(DenseDFA::compiled, inputs, verdicts);
+                return verdicts;
+            }
+            for (size_t i = 0; i < inputs.size(); i++) {
+                if (RegexBuilder::matchString(inputs[i], RegexAutomata::MatchEngine::Auto)) {
+                    verdicts[i >> 6] |= uint64_t(1) << (i & 63);
+                }
+            }
+        } catch (const std::exception& e) {
+            std::fill(verdicts.begin(), verdicts.end(), 0);
+        }
+        return verdicts;
+    }
+    
+    std::string getLastMatchEngine() {
+        return lastMatchEngine;
+    }
+    
+    std::string getLastError() {
+        return lastError;
+    }
+    
+    // 生成NFA的描述信息
+    void generateNFADescription() {
         // 生成NFA描述
         std::ostringstream nfa_oss;
         nfa_oss << "NFA States: " << NFAManager::states.size() << "\n";
+        nfa_oss << "NFA Memory: " << DataStructures::nfa.memory_usage() << " bytes\n";
         nfa_oss << "Initial State: " << NFAManager::initial_state << "\n";
+        if (BitParallel::compiled.ready) {
+            nfa_oss << "Bit-parallel matcher: " << BitParallel::compiled.positions << " positions ("
+                    << (BitParallel::compiled.shift_and ? "shift-and" : "follow tables") << ")\n";
+        } else {
+            nfa_oss << "Bit-parallel matcher: not used (more than " << BitParallel::MAX_POSITIONS << " positions)\n";
+        }
+        Prefilter::Finder prefilter(searchPrefixes, DataStructures::nfa, nfaStartState);
+        nfa_oss << "Search prefilter: " << prefilter.describe() << "\n";
+        if (construction == RegexAutomata::Construction::Glushkov) {
+            nfa_oss << "Construction: glushkov (" << DataStructures::nfa.state_count - 1 << " positions, no ε-edges)\n";
+        } else {
+            nfa_oss << "Construction: thompson\n";
+        }
+        for (const auto& pass : RegexOptimizer::last_report) {
+            nfa_oss << "Optimizer " << pass.name << ": " << pass.before.states << " -> " << pass.after.states
+                    << " states, " << pass.before.epsilons << " -> " << pass.after.epsilons << " ε-edges\n";
+        }
+        for (const auto& counter : DataStructures::nfa.counters) {
+            nfa_oss << "Counter: state " << counter.state << " repeats {" << counter.min << ","
+                    << (counter.max == -1 ? std::string() : std::to_string(counter.max)) << "}\n";
+        }
         nfa_oss << "Accept States: ";
         for (const auto& state : NFAManager::accept_states) {
             nfa_oss << state << " ";
@@ -780,9 +4197,27 @@ namespace RegexBuilder {
             nfa_oss << "  δ(" << from << ", " << symbol << ") = " << to << "\n";
         }
         nfaDescription = nfa_oss.str();
-        
-        // 生成DFA描述
+    }
+    
+    // 生成DFA的描述信息
+    void generateDFADescription() {
         std::ostringstream dfa_oss;
+        dfa_oss << constructionStats;
+        if (countingMode) {
+            dfa_oss << "DFA not built: the NFA uses " << DataStructures::nfa.counters.size()
+                    << " repetition counter(s)\n";
+            dfa_oss << "Matching simulates the NFA with counting sets\n";
+            dfaDescription = dfa_oss.str();
+            return;
+        }
+        if (lazyMode) {
+            dfa_oss << "DFA States: more than the limit of " << DFAConverter::max_dfa_transitions
+                    << " transitions (states x byte classes), full DFA not built\n";
+            dfa_oss << "Matching uses a lazy DFA (cache limit " << LazyDFA::MAX_CACHED_STATES
+                    << " states, NFA simulation on thrashing)\n";
+            dfaDescription = dfa_oss.str();
+            return;
+        }
         dfa_oss << "DFA States: " << DFAManager::states.size() << "\n";
         dfa_oss << "Initial State: " << DFAManager::initial_state << "\n";
         dfa_oss << "Accept States: ";
@@ -790,14 +4225,16 @@ namespace RegexBuilder {
             dfa_oss << state << " ";
         }
         dfa_oss << "\nTransitions: " << DFAManager::transitions.size() << " total\n";
-        for (const auto& [from, symbol, to] : DFAManager::transitions) {
+        bool listed = DFAManager::state_count <= MAX_VISUALIZED_STATES;
+        for (size_t i = 0; listed && i < DFAManager::transitions.size(); i++) {
+            const auto& [from, symbol, to] = DFAManager::transitions[i];
             dfa_oss << "  δ(" << from << ", " << symbol << ") = " << to << "\n";
         }
         
         // 添加最小化信息
         dfa_oss << "\nMinimized DFA:\n";
         dfa_oss << "Partitions: " << DFAMinimizer::partitions.size() << "\n";
-        for (int i = 0; i < DFAMinimizer::partitions.size(); i++) {
+        for (int i = 0; listed && i < DFAMinimizer::partitions.size(); i++) {
             dfa_oss << "  Partition " << i << ": {";
             bool first = true;
             for (auto state : DFAMinimizer::partitions[i]) {
@@ -808,8 +4245,32 @@ namespace RegexBuilder {
             dfa_oss << "}\n";
         }
         dfa_oss << "Minimized Transitions: " << DFAMinimizer::minimized_transitions.size() << " total\n";
-        for (const auto& [from, symbol, to] : DFAMinimizer::minimized_transitions) {
-            dfa_oss << "  δ(" << from << ", " << symbol << ") = " << to << "\n";
+        for (size_t i = 0; listed && i < DFAMinimizer::minimized_transitions.size(); i++) {
+            const auto& [from, lo, hi, to] = DFAMinimizer::minimized_transitions[i];
+            dfa_oss << "  δ(" << from << ", " << DataStructures::range_label(lo, hi) << ") = " << to << "\n";
+        }
+        if (!listed) {
+            dfa_oss << "  (partitions and transitions not listed: more than " << MAX_VISUALIZED_STATES << " states)\n";
+        }
+        
+        // 稠密匹配表信息
+        const DenseDFA::Table& table = DenseDFA::compiled;
+        dfa_oss << "\nDense Table: " << table.state_count << " states (incl. dead state) x "
+                << table.class_count << " byte classes\n";
+        dfa_oss << "State Order:";
+        for (int state = 1; listed && state < table.state_count; state++) {
+            dfa_oss << " " << table.state_to_partition[state];
+        }
+        dfa_oss << "\n";
+        dfa_oss << "Accelerated States: " << table.accelerators.size() << "\n";
+        int firstAccelerated = table.state_count - table.accelerators.size();
+        for (size_t i = 0; listed && i < table.accelerators.size(); i++) {
+            const DenseDFA::Accelerator& accel = table.accelerators[i];
+            dfa_oss << "  Partition " << table.state_to_partition[firstAccelerated + i] << " escapes on";
+            for (int k = 0; k < accel.count; k++) {
+                dfa_oss << " " << DataStructures::range_label(accel.escapes[k], accel.escapes[k]);
+            }
+            dfa_oss << "\n";
         }
         
         dfaDescription = dfa_oss.str();
@@ -822,6 +4283,7 @@ namespace RegexBuilder {
     
     // 获取DFA描述
     std::string getDFADescription() {
+        ensureDFA();
         return dfaDescription;
     }
     
@@ -835,9 +4297,30 @@ namespace RegexBuilder {
         return isInitialized;
     }
     
+    int getNFAStartState() {
+        return nfaStartState;
+    }
+    
+    bool isLazyMode() {
+        ensureDFA();
+        return lazyMode;
+    }
+    
+    bool isCountingMode() {
+        return countingMode;
+    }
+    
+    RegexAutomata::Construction getConstruction() {
+        return construction;
+    }
+    
+    const std::vector<std::string>& getSearchPrefixes() {
+        return searchPrefixes;
+    }
+    
     // 生成NFA的DOT文件内容
     std::string generateNFADotContent() {
-        if (!isInitialized) return "";
+        if (!isInitialized || construction == RegexAutomata::Construction::Derivative) return "";
         
         std::stringstream dot;
         dot << "digraph NFA {" << std::endl;
@@ -863,7 +4346,7 @@ namespace RegexBuilder {
         // 生成转移边
         for (const auto& [from, symbol, to] : NFAManager::transitions) {
             dot << "    " << from << " -> " << to;
-            if (symbol == '#') {
+            if (symbol == DataStructures::EPSILON_LABEL) {
                 dot << " [label=\"ε\"];" << std::endl;  // epsilon转换
             } else {
                 dot << " [label=\"" << symbol << "\"];" << std::endl;
@@ -876,7 +4359,8 @@ namespace RegexBuilder {
     
     // 生成DFA的DOT文件内容
     std::string generateDFADotContent() {
-        if (!isInitialized) return "";
+        ensureDFA();
+        if (!isInitialized || lazyMode || countingMode || DFAManager::state_count > MAX_VISUALIZED_STATES) return "";
         
         std::stringstream dot;
         dot << "digraph DFA {" << std::endl;
@@ -913,7 +4397,8 @@ namespace RegexBuilder {
     
     // 生成最小化DFA的DOT文件内容
     std::string generateMinimizedDFADotContent() {
-        if (!isInitialized) return "";
+        ensureDFA();
+        if (!isInitialized || lazyMode || countingMode || DFAManager::state_count > MAX_VISUALIZED_STATES) return "";
         
         std::stringstream dot;
         dot << "digraph MinimizedDFA {" << std::endl;
@@ -953,9 +4438,9 @@ namespace RegexBuilder {
         dot << std::endl;
         
         // 生成转移边
-        for (const auto& [from, symbol, to] : DFAMinimizer::minimized_transitions) {
+        for (const auto& [from, lo, hi, to] : DFAMinimizer::minimized_transitions) {
             dot << "    " << from << " -> " << to;
-            dot << " [label=\"" << symbol << "\"];" << std::endl;
+            dot << " [label=\"" << DataStructures::range_label(lo, hi) << "\"];" << std::endl;
         }
         
         dot << "}" << std::endl;
@@ -976,13 +4461,37 @@ namespace RegexBuilder {
 namespace RegexAutomata {
     
     // 自动机构建
-    bool buildFromRegex(const std::string& regex) {
-        return RegexBuilder::buildAutomataFromRegex(regex);
+    bool buildFromRegex(const std::string& regex, Construction construction) {
+        return RegexBuilder::buildAutomataFromRegex(regex, construction);
     }
     
     // 字符串匹配
-    bool matchString(const std::string& input) {
-        return RegexBuilder::matchString(input);
+    bool matchString(const std::string& input, MatchEngine engine) {
+        return RegexBuilder::matchString(input, engine);
+    }
+    
+    bool matchWithCaptures(const std::string& input, std::vector<std::pair<int, int>>& groups) {
+        return RegexBuilder::matchWithCaptures(input, groups);
+    }
+    
+    bool extractCaptures(const std::string& input, std::vector<std::pair<int, int>>& groups) {
+        return RegexBuilder::matchWithCaptures(input, groups, true);
+    }
+    
+    std::string getTaggedDFADescription() {
+        return RegexBuilder::getTaggedDFADescription();
+    }
+    
+    std::vector<uint64_t> matchBatch(const std::vector<std::string>& inputs) {
+        return RegexBuilder::matchBatch(inputs);
+    }
+    
+    std::string getLastMatchEngine() {
+        return RegexBuilder::getLastMatchEngine();
+    }
+    
+    std::string getLastError() {
+        return RegexBuilder::getLastError();
     }
     
     // 获取自动机描述
@@ -1032,8 +4541,8 @@ namespace RegexAutomata {
         }
         
         std::cout << "Minimized Transitions: ";
-        for (const auto& [from, symbol, to] : DFAMinimizer::minimized_transitions) {
-            std::cout << "f(" << from << ", " << symbol << ") = " << to << " ";
+        for (const auto& [from, lo, hi, to] : DFAMinimizer::minimized_transitions) {
+            std::cout << "f(" << from << ", " << DataStructures::range_label(lo, hi) << ") = " << to << " ";
         }
         std::cout << "\n";
     }
@@ -1046,4 +4555,367 @@ namespace RegexAutomata {
     bool isBuilt() {
         return RegexBuilder::isReady();
     }
+    
+    bool usesLazyDFA() {
+        return RegexBuilder::isLazyMode();
+    }
+    
+    void setDFATransitionLimit(size_t transitions) {
+        DFAConverter::max_dfa_transitions = std::max<size_t>(1, transitions);
+    }
+    
+    size_t getDFATransitionLimit() {
+        return DFAConverter::max_dfa_transitions;
+    }    
+    // 流式搜索：缓冲区从当前搜索起点开始保存输入，供反向扫描和匹配后重扫使用
+    struct StreamMatcher::Impl {
+        DataStructures::CompactAutomaton nfa; // 构造时复制，之后重新构建正则表达式不影响本对象
+        StreamSearch::ForwardDFA forward;
+        StreamSearch::ReverseDFA reverse;
+        Prefilter::Finder prefilter;
+        size_t prefilterCalls = 0;
+        size_t prefilterSkipped = 0;
+        
+        std::string buffer;
+        size_t base = 0;     // buffer[0] 在整个流中的偏移
+        size_t scan = 0;     // 下一个待扫描字节
+        size_t origin = 0;   // 匹配起点的下界
+        size_t lastEnd = 0;  // 候选匹配的终点
+        int state = 0;
+        
+        Impl(const DataStructures::CompactAutomaton& automaton, int start_state, const std::vector<std::string>& prefixes)
+            : nfa(automaton), forward(nfa, start_state), reverse(nfa, start_state), prefilter(prefixes, nfa, start_state) {
+            restart(0, true);
+        }
+        
+        // 从 at 开始新的搜索；上一个匹配为空串时不允许在同一位置再次开始
+        void restart(size_t at, bool allowStartHere) {
+            scan = at;
+            origin = allowStartHere ? at : at + 1;
+            state = allowStartHere ? forward.initial_state() : forward.no_start_state();
+            if (forward.state(state).accepting) lastEnd = at;
+        }
+        
+        void emit(std::vector<SearchMatch>& matches) {
+            long long start = reverse.longest_start(buffer, origin, lastEnd);
+            if (start < 0) start = lastEnd; // 前向已确认匹配存在，不应发生
+            matches.push_back({base + (size_t)start, base + lastEnd});
+            restart(lastEnd, (size_t)start != lastEnd);
+        }
+        
+        void run(std::vector<SearchMatch>& matches) {
+            while (scan < buffer.size()) {
+                // 没有进行中的匹配时直接跳到下一个可能的起点
+                if (state == forward.initial_state() && prefilter.type() != Prefilter::Finder::Kind::None) {
+                    size_t next = prefilter.find(buffer, scan);
+                    prefilterSkipped += next - scan;
+                    scan = origin = next;
+                    if (scan == buffer.size()) break;
+                    // 候选位置过密时预过滤只是额外开销，此后不再使用
+                    if (++prefilterCalls >= Prefilter::PROBATION_CALLS &&
+                        prefilterSkipped < prefilterCalls * Prefilter::MIN_AVERAGE_SKIP) {
+                        prefilter.disable();
+                    }
+                }
+                state = forward.step(state, (unsigned char)buffer[scan]);
+                scan++;
+                const StreamSearch::ForwardState& current = forward.state(state);
+                if (current.accepting) lastEnd = scan;
+                if (current.done) {
+                    emit(matches);
+                } else if (current.fresh) {
+                    origin = scan;
+                }
+            }
+            
+            // 丢弃不会再被访问的前缀，超过一半时才搬移以免反复拷贝
+            size_t keep = std::min(origin, scan);
+            if (forward.state(state).flagged) keep = std::min(keep, lastEnd);
+            if (keep > 0 && keep * 2 >= buffer.size()) {
+                buffer.erase(0, keep);
+                base += keep;
+                scan -= keep;
+                origin -= keep;
+                lastEnd = lastEnd >= keep ? lastEnd - keep : 0;
+            }
+        }
+    };
+    
+    StreamMatcher::StreamMatcher() {
+        if (!RegexBuilder::isReady()) {
+            throw std::runtime_error("Regex automata not built");
+        }
+        if (!RegexBuilder::isCountingMode() && RegexBuilder::getConstruction() != Construction::Derivative) {
+            impl = std::make_unique<Impl>(DataStructures::nfa, RegexBuilder::getNFAStartState(),
+                                          RegexBuilder::getSearchPrefixes());
+            return;
+        }
+        
+        // 计数器无法确定化，导数模式没有NFA：重新编译一份完全展开的Thompson NFA（不支持 & 和 ~）
+        DataStructures::CompactAutomaton expanded;
+        int start_state = 0;
+        std::vector<int> pattern_of_accept;
+        if (RegexBuilder::compilePatternSet({RegexBuilder::getCurrentRegex()}, expanded, start_state, pattern_of_accept) >= 0) {
+            throw std::runtime_error(RegexBuilder::getLastError());
+        }
+        impl = std::make_unique<Impl>(expanded, start_state, RegexBuilder::getSearchPrefixes());
+    }
+    
+    StreamMatcher::~StreamMatcher() = default;
+    
+    std::vector<SearchMatch> StreamMatcher::feed(const std::string& chunk) {
+        std::vector<SearchMatch> matches;
+        impl->buffer += chunk;
+        impl->run(matches);
+        return matches;
+    }
+    
+    std::vector<SearchMatch> StreamMatcher::finish() {
+        std::vector<SearchMatch> matches;
+        // 输入结束：仍有候选匹配时它就是最终结果，输出后从其终点继续扫描剩余输入
+        while (impl->forward.state(impl->state).flagged) {
+            impl->emit(matches);
+            impl->run(matches);
+        }
+        impl->buffer.clear();
+        impl->base += impl->scan;
+        impl->restart(0, true);
+        return matches;
+    }
+    
+    size_t StreamMatcher::bufferedBytes() const {
+        return impl->buffer.size();
+    }
+    
+    std::vector<SearchMatch> searchAll(const std::string& text) {
+        StreamMatcher matcher;
+        std::vector<SearchMatch> matches = matcher.feed(text);
+        std::vector<SearchMatch> rest = matcher.finish();
+        matches.insert(matches.end(), rest.begin(), rest.end());
+        return matches;
+    }    
+    struct RegexSet::Impl {
+        std::vector<std::string> patterns;
+        std::unique_ptr<PatternSet::ProductDFA> product;
+    };
+    
+    RegexSet::RegexSet(const std::vector<std::string>& patterns) : impl(std::make_unique<Impl>()) {
+        if (patterns.empty()) {
+            throw std::runtime_error("Regex set requires at least one pattern");
+        }
+        
+        DataStructures::CompactAutomaton automaton;
+        int start_state = 0;
+        std::vector<int> pattern_of_accept;
+        int failed = RegexBuilder::compilePatternSet(patterns, automaton, start_state, pattern_of_accept);
+        if (failed >= 0) {
+            throw std::runtime_error("Invalid pattern at index " + std::to_string(failed) + " (" + patterns[failed] +
+                                     "): " + RegexBuilder::getLastError());
+        }
+        
+        impl->patterns = patterns;
+        impl->product = std::make_unique<PatternSet::ProductDFA>(std::move(automaton), start_state,
+                                                                 std::move(pattern_of_accept), patterns.size());
+    }
+    
+    RegexSet::~RegexSet() = default;
+    
+    std::vector<int> RegexSet::matches(const std::string& input) {
+        const std::vector<uint64_t>& bits = impl->product->run(input);
+        std::vector<int> result;
+        for (size_t i = 0; i < impl->patterns.size(); i++) {
+            if ((bits[i / 64] >> (i % 64)) & 1) result.push_back(i);
+        }
+        return result;
+    }
+    
+    bool RegexSet::isMatch(const std::string& input) {
+        for (uint64_t word : impl->product->run(input)) {
+            if (word != 0) return true;
+        }
+        return false;
+    }
+    
+    size_t RegexSet::size() const {
+        return impl->patterns.size();
+    }
+    
+    const std::string& RegexSet::pattern(size_t index) const {
+        return impl->patterns.at(index);
+    }
+    
+    size_t RegexSet::cachedStates() const {
+        return impl->product->cached_states();
+    }
+    
+    int RegexSet::nfaStates() const {
+        return impl->product->nfa_states();
+    }
+    
+    struct LineScanner::Impl {
+        // 三种方式：整段一次扫过（换行总进入死状态）、逐行用稠密DFA、逐行模拟NFA（DFA超过规模上限）
+        enum class Mode { Lines, LineDFA, LineNFA };
+        Mode mode = Mode::Lines;
+        DenseDFA::Table table; // 整行匹配的稠密DFA，构造后只读
+        DataStructures::CompactAutomaton nfa;
+        int nfaStart = 0;
+        
+        // 顶层选择的一个分支；开头的 ^ 与结尾的 $ 已去掉，改为行首、行尾锚点
+        struct Branch {
+            std::string body;
+            bool atLineStart = false;
+            bool atLineEnd = false;
+        };
+        
+        // 按顶层 | 切分模式（跳过转义、字符类和括号内部）。^ 和 $ 只能出现在分支首尾，否则抛出异常
+        static std::vector<Branch> splitBranches(const std::string& regex) {
+            std::vector<Branch> branches(1);
+            size_t begin = 0;
+            int depth = 0;
+            auto misplaced = [](char anchor, size_t position) {
+                return std::runtime_error(std::string("Anchor '") + anchor + "' at position " + std::to_string(position) +
+                                          " is only supported at the start or end of a top-level alternative (use \\" +
+                                          anchor + " for a literal)");
+            };
+            for (size_t i = 0; i <= regex.size(); i++) {
+                if (i == regex.size() || (regex[i] == '|' && depth == 0)) {
+                    if (!branches.back().atLineEnd) branches.back().body = regex.substr(begin, i - begin);
+                    if (i < regex.size()) branches.emplace_back();
+                    begin = i + 1;
+                    continue;
+                }
+                char c = regex[i];
+                if (c == '\\') {
+                    i++;
+                } else if (c == '[') {
+                    i++;
+                    if (i < regex.size() && regex[i] == '^') i++;
+                    if (i < regex.size() && regex[i] == ']') i++;
+                    for (; i < regex.size() && regex[i] != ']'; i++) {
+                        if (regex[i] == '\\') i++;
+                    }
+                } else if (c == '(') {
+                    depth++;
+                } else if (c == ')') {
+                    depth--;
+                } else if (c == '^') {
+                    if (depth != 0 || i != begin) throw misplaced(c, i);
+                    branches.back().atLineStart = true;
+                    begin = i + 1;
+                } else if (c == '$') {
+                    bool branchEnd = i + 1 == regex.size() || regex[i + 1] == '|';
+                    if (depth != 0 || !branchEnd) throw misplaced(c, i);
+                    branches.back().atLineEnd = true;
+                    branches.back().body = regex.substr(begin, i - begin);
+                }
+            }
+            return branches;
+        }
+    };
+    
+    LineScanner::LineScanner(const std::string& regex) : impl(std::make_unique<Impl>()) {
+        bool hadRegex = RegexBuilder::isReady();
+        std::string previousRegex = RegexBuilder::getCurrentRegex();
+        Construction previousConstruction = RegexBuilder::getConstruction();
+        
+        // 先单独编译一次，语法错误的位置对应用户给出的模式。整行模式优先用导数构造：各分支的语法树与 [^\n]* 求交，
+        // 保证匹配不跨行，未锚定的一侧接上 [^\n]*，最小化后所有接受状态合并为一个只在换行处离开的加速状态。
+        // 语法树直接拼接，用户模式中的 & 和 ~ 仍是普通字符。导数构造因重复上界失败时改用文本拼接的
+        // Thompson构造逐行匹配；导数DFA或完整DFA超过规模上限时逐行模拟NFA
+        std::string error;
+        std::vector<Impl::Branch> branches;
+        if (!RegexBuilder::buildAutomataFromRegex(regex, Construction::Thompson)) {
+            error = RegexBuilder::getLastError();
+        } else {
+            try {
+                branches = Impl::splitBranches(regex);
+            } catch (const std::runtime_error& e) {
+                error = e.what();
+            }
+        }
+        
+        if (error.empty()) {
+            using RegexParser::NodeType;
+            RegexParser::NodePtr restOfLine =
+                RegexParser::make_node(NodeType::Star, {RegexParser::make_class(RegexParser::negate({{'\n', '\n'}}))});
+            std::vector<RegexParser::NodePtr> alternatives;
+            try {
+                for (const auto& branch : branches) {
+                    RegexParser::Parser parser(branch.body);
+                    std::vector<RegexParser::NodePtr> parts;
+                    if (!branch.atLineStart) parts.push_back(restOfLine);
+                    parts.push_back(RegexParser::make_node(NodeType::Intersect, {parser.parse(), restOfLine}));
+                    if (!branch.atLineEnd) parts.push_back(restOfLine);
+                    alternatives.push_back(RegexParser::make_node(NodeType::Concat, parts));
+                }
+                RegexParser::NodePtr root = alternatives.size() == 1
+                    ? alternatives[0] : RegexParser::make_node(NodeType::Alternate, alternatives);
+                
+                RegexBuilder::resetState();
+                DerivativeDFA::build(root, DFAConverter::max_dfa_transitions);
+                DFAManager::initialize();
+                DFAMinimizer::minimize_dfa();
+                DenseDFA::compile();
+                impl->table = DenseDFA::compiled;
+                impl->mode = Impl::Mode::Lines;
+            } catch (const std::runtime_error& e) {
+                // 已经得到状态说明是超过规模上限（而不是重复上界），子集构造多半也会超限，直接逐行模拟NFA
+                impl->mode = DataStructures::dfa.state_count > 0 ? Impl::Mode::LineNFA : Impl::Mode::LineDFA;
+            }
+        }
+        
+        if (error.empty() && impl->mode != Impl::Mode::Lines) {
+            std::string line;
+            for (const auto& branch : branches) {
+                if (!line.empty()) line += "|";
+                line += (branch.atLineStart ? "(?:" : "[^\\n]*(?:") + branch.body + (branch.atLineEnd ? ")" : ")[^\\n]*");
+            }
+            if (!RegexBuilder::buildAutomataFromRegex(line, Construction::Thompson)) {
+                error = RegexBuilder::getLastError();
+            } else {
+                if (impl->mode == Impl::Mode::LineNFA || RegexBuilder::isCountingMode() || RegexBuilder::isLazyMode()) {
+                    impl->mode = Impl::Mode::LineNFA;
+                    impl->nfa = DataStructures::nfa;
+                    impl->nfaStart = RegexBuilder::getNFAStartState();
+                } else {
+                    impl->table = DenseDFA::compiled;
+                }
+            }
+        }
+        
+        if (hadRegex) {
+            RegexBuilder::buildAutomataFromRegex(previousRegex, previousConstruction);
+        } else {
+            RegexBuilder::resetState();
+        }
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+    
+    LineScanner::~LineScanner() = default;
+    
+    std::vector<size_t> LineScanner::matchingLines(const char* data, size_t size) const {
+        std::vector<size_t> lines;
+        const unsigned char* bytes = (const unsigned char*)data;
+        if (impl->mode == Impl::Mode::Lines) {
+            DenseDFA::match_lines(impl->table, bytes, size, lines);
+            return lines;
+        }
+        size_t line = 0;
+        while (line < size) {
+            const void* newline = std::memchr(data + line, '\n', size - line);
+            size_t end = newline ? (const char*)newline - data : size;
+            bool matched = impl->mode == Impl::Mode::LineDFA
+                ? DenseDFA::match_range(impl->table, bytes + line, end - line)
+                : CountingNFA::match(impl->nfa, impl->nfaStart, bytes + line, end - line);
+            if (matched) lines.push_back(line);
+            line = end + 1;
+        }
+        return lines;
+    }
+    
+    int LineScanner::dfaStates() const {
+        return impl->mode == Impl::Mode::LineNFA ? 0 : impl->table.state_count - 1;
+    }
 }
\ No newline at end of file
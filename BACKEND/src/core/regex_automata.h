@@ -2,13 +2,125 @@
 #define REGEX_AUTOMATA_H
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
 
 namespace RegexAutomata {
-    // 自动机构建
-    bool buildFromRegex(const std::string& regex);
+    // 自动机构建。语法：| * + ? {m} {m,} {m,n} ( ) (?: ) . [...] [^...] 以及转义 \d \w \s \D \W \S \n \t \r \f \v \0 \xHH，
+    // \uHHHH \u{H...}，其余字节表示自身；字符类编译为单条字节区间转移。
+    // 含非ASCII字符（UTF-8 或 \u）的字符与字符类按码点匹配，编译为UTF-8字节序列自动机；. 与 \xHH 仍按字节。
+    // 单个字符类的大边界计数重复（如 [0-9]{1,64}）编译为计数器，此时不构建DFA，匹配用计数集合模拟
+    // NFA构造方式：Thompson（带ε转移，支持捕获组和计数器）或 Glushkov（位置自动机，无ε转移，
+    // m 个字符位置对应 m+1 个状态；不记录捕获组，DFA描述中附带与Thompson路径的子集构造对比）
+    // 或 Derivative（Brzozowski导数直接构造DFA，不构建NFA；额外支持交 r&s 与补 ~r，优先级：| 低于 & 低于拼接，
+    // ~ 为前缀运算符；不记录捕获组，流式搜索不支持 & 和 ~，DFA描述中附带与Thompson路径的对比）
+    enum class Construction { Thompson, Glushkov, Derivative };
+    
+    bool buildFromRegex(const std::string& regex, Construction construction = Construction::Thompson);
+    
+    // 最近一次构建失败的原因（语法错误及其位置）
+    std::string getLastError();
+    
+    // 匹配引擎：Auto 在模式不超过64个字符位置时用位并行匹配（无需DFA），否则在DFA尚未构建且输入较短时
+    // 直接用Pike VM（省去DFA构建），再否则用DFA；BitParallel 在位置过多时按 Auto 选择
+    enum class MatchEngine { Auto, DFA, PikeVM, BitParallel };
     
     // 字符串匹配
-    bool matchString(const std::string& input);
+    bool matchString(const std::string& input, MatchEngine engine = MatchEngine::Auto);
+    
+    // 带捕获组的匹配：groups[k] 为第 k 个括号组最后一次匹配的 [start, end)，
+    // 未参与匹配的组为 {-1, -1}，groups[0] 为整个输入。带标签的DFA已构建或输入较长时用它，否则用Pike VM
+    bool matchWithCaptures(const std::string& input, std::vector<std::pair<int, int>>& groups);
+    
+    // 字段提取：结果与 matchWithCaptures 相同，总是使用带标签的DFA（首次调用时构建，之后逐字节查表并执行寄存器操作，
+    // 时间与输入长度成线性）；状态数超限时退回Pike VM
+    bool extractCaptures(const std::string& input, std::vector<std::pair<int, int>>& groups);
+    
+    // 带标签的DFA的统计（状态数、寄存器数、寄存器操作数），尚未构建时为空
+    std::string getTaggedDFADescription();
+    
+    // 批量匹配：返回位图，第 i 位（verdicts[i / 64] 的第 i % 64 位）为第 i 个输入是否匹配。
+    // 有完整DFA时若干输入在同一循环中交错推进以重叠访存延迟，否则逐个按 Auto 匹配
+    std::vector<uint64_t> matchBatch(const std::vector<std::string>& inputs);
+    
+    // 最近一次匹配使用的引擎："bitparallel"、"dfa"、"lazy-dfa"、"pikevm"、"tagged-dfa" 或 "counting"
+    std::string getLastMatchEngine();
+    
+    // 无锚点搜索的匹配结果：[start, end) 为在整个输入（流）中的偏移
+    struct SearchMatch {
+        size_t start;
+        size_t end;
+    };
+    
+    // 可恢复的流式搜索器：分块送入输入，返回最左最长、互不重叠的匹配。
+    // 构造时复制当前已构建的自动机（未构建时抛出 std::runtime_error；含计数器时复制完全展开的版本）；
+    // 缓冲区只保留尚未确定的匹配可能覆盖的输入
+    class StreamMatcher {
+    public:
+        StreamMatcher();
+        ~StreamMatcher();
+        StreamMatcher(const StreamMatcher&) = delete;
+        StreamMatcher& operator=(const StreamMatcher&) = delete;
+        
+        // 送入一块输入，返回已经确定的匹配
+        std::vector<SearchMatch> feed(const std::string& chunk);
+        // 输入结束，返回剩余的匹配；之后可作为新流继续使用（偏移继续累加）
+        std::vector<SearchMatch> finish();
+        size_t bufferedBytes() const;
+        
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+    
+    // 在整个文本中搜索所有匹配
+    std::vector<SearchMatch> searchAll(const std::string& text);
+    
+    // 多模式集合：所有模式编译进一个NFA，按需确定化为乘积DFA，一次扫描得到所有匹配的模式（整串匹配）。
+    // 与单个正则表达式的全局状态互不影响；模式非法时抛出 std::runtime_error
+    class RegexSet {
+    public:
+        explicit RegexSet(const std::vector<std::string>& patterns);
+        ~RegexSet();
+        RegexSet(const RegexSet&) = delete;
+        RegexSet& operator=(const RegexSet&) = delete;
+        
+        // 匹配输入的模式下标（升序）
+        std::vector<int> matches(const std::string& input);
+        bool isMatch(const std::string& input);
+        
+        size_t size() const;
+        const std::string& pattern(size_t index) const;
+        size_t cachedStates() const; // 已确定化的乘积DFA状态数
+        int nfaStates() const;
+        
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+    
+    // 按行匹配（grep）：编译 [^\n]*(?:regex)[^\n]* 的稠密DFA并保存一份副本，之后只读，可在多个线程中同时使用。
+    // 与 grep 一样，顶层分支开头的 ^ 和结尾的 $ 表示行首、行尾（字面字符写作 \^、\$），出现在其他位置时视为错误；
+    // DFA超过规模上限时逐行模拟NFA。构造时借用全局构建流程，完成后恢复此前已构建的正则表达式；
+    // 模式非法时抛出 std::runtime_error
+    class LineScanner {
+    public:
+        explicit LineScanner(const std::string& regex);
+        ~LineScanner();
+        LineScanner(const LineScanner&) = delete;
+        LineScanner& operator=(const LineScanner&) = delete;
+        
+        // [data, data + size) 中含有匹配的行的起始偏移（升序）；行以 '\n' 分隔，最后一行可以没有换行
+        std::vector<size_t> matchingLines(const char* data, size_t size) const;
+        int dfaStates() const; // 不含死状态；逐行模拟NFA时为 0
+        
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
     
     // 获取自动机描述
     std::string getNFADescription();
@@ -27,6 +139,14 @@ namespace RegexAutomata {
     // 自动机状态管理
     void reset();
     bool isBuilt();
+    
+    // 完整DFA超过规模上限时不构建DFA，匹配改用惰性DFA（DFA相关的描述和DOT为空）
+    bool usesLazyDFA();
+    
+    // 完整DFA（以及导数构造、带标签的DFA）的规模上限，按稠密表的转移数（状态数 × 字节类数）计，默认 4M（16MB）；
+    // 对之后构建的DFA生效
+    void setDFATransitionLimit(size_t transitions);
+    size_t getDFATransitionLimit();
 }
 
 #endif // REGEX_AUTOMATA_H
@@ -1,4 +1,5 @@
 #include "slr1_parser.h"
+#include "grammar_precedence.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -8,6 +9,182 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <numeric>
+#include <cmath>
+#include <cstdlib>
+
+// 语义动作命名空间 - 产生式末尾的 "{ $1 + $3 }" 在读入文法时编译为后缀指令序列，归约时直接在值栈上求值
+namespace SemanticAction_SLR1 {
+    enum class OpCode { PushConstant, PushArgument, Add, Subtract, Multiply, Divide, Modulo, Negate };
+
+    struct Instruction {
+        OpCode op;
+        double constant = 0;
+        int argument = 0; // $n 中的 n（从1开始）
+    };
+
+    using Program = std::vector<Instruction>;
+
+    // 编译状态（递归下降）
+    struct CompileState {
+        const std::string& text;
+        size_t position;
+        Program program;
+        int maxArgument;
+    };
+
+    // 解析完整的数字串，如 "3"、"-2.5"
+    bool parseNumber(const std::string& text, double& value) {
+        if (text.empty()) return false;
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end == text.c_str() + text.size();
+    }
+
+    void skipSpaces(CompileState& state) {
+        while (state.position < state.text.size() && std::isspace(static_cast<unsigned char>(state.text[state.position]))) {
+            state.position++;
+        }
+    }
+
+    bool compileExpression(CompileState& state);
+
+    // primary := number | $n | '(' expr ')'
+    bool compilePrimary(CompileState& state) {
+        skipSpaces(state);
+        if (state.position >= state.text.size()) return false;
+
+        char currentChar = state.text[state.position];
+        if (currentChar == '(') {
+            state.position++;
+            if (!compileExpression(state)) return false;
+            skipSpaces(state);
+            if (state.position >= state.text.size() || state.text[state.position] != ')') return false;
+            state.position++;
+            return true;
+        }
+
+        if (currentChar == '$') {
+            size_t digitStart = ++state.position;
+            while (state.position < state.text.size() && std::isdigit(static_cast<unsigned char>(state.text[state.position]))) {
+                state.position++;
+            }
+            if (state.position == digitStart) return false;
+
+            Instruction instruction{OpCode::PushArgument};
+            instruction.argument = std::stoi(state.text.substr(digitStart, state.position - digitStart));
+            if (instruction.argument < 1) return false;
+            state.maxArgument = std::max(state.maxArgument, instruction.argument);
+            state.program.push_back(instruction);
+            return true;
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(currentChar)) || currentChar == '.') {
+            size_t numberStart = state.position;
+            while (state.position < state.text.size() &&
+                   (std::isdigit(static_cast<unsigned char>(state.text[state.position])) || state.text[state.position] == '.')) {
+                state.position++;
+            }
+
+            Instruction instruction{OpCode::PushConstant};
+            if (!parseNumber(state.text.substr(numberStart, state.position - numberStart), instruction.constant)) return false;
+            state.program.push_back(instruction);
+            return true;
+        }
+
+        return false;
+    }
+
+    // unary := '-' unary | primary
+    bool compileUnary(CompileState& state) {
+        skipSpaces(state);
+        if (state.position < state.text.size() && state.text[state.position] == '-') {
+            state.position++;
+            if (!compileUnary(state)) return false;
+            state.program.push_back({OpCode::Negate});
+            return true;
+        }
+        return compilePrimary(state);
+    }
+
+    // term := unary (('*' | '/' | '%') unary)*
+    bool compileTerm(CompileState& state) {
+        if (!compileUnary(state)) return false;
+        while (true) {
+            skipSpaces(state);
+            if (state.position >= state.text.size()) return true;
+
+            char op = state.text[state.position];
+            OpCode code;
+            if (op == '*') code = OpCode::Multiply;
+            else if (op == '/') code = OpCode::Divide;
+            else if (op == '%') code = OpCode::Modulo;
+            else return true;
+
+            state.position++;
+            if (!compileUnary(state)) return false;
+            state.program.push_back({code});
+        }
+    }
+
+    // expr := term (('+' | '-') term)*
+    bool compileExpression(CompileState& state) {
+        if (!compileTerm(state)) return false;
+        while (true) {
+            skipSpaces(state);
+            if (state.position >= state.text.size()) return true;
+
+            char op = state.text[state.position];
+            if (op != '+' && op != '-') return true;
+
+            state.position++;
+            if (!compileTerm(state)) return false;
+            state.program.push_back({op == '+' ? OpCode::Add : OpCode::Subtract});
+        }
+    }
+
+    // 编译表达式文本，失败时返回 false
+    bool compile(const std::string& text, Program& program, int& maxArgument) {
+        CompileState state{text, 0, {}, 0};
+        if (!compileExpression(state)) return false;
+        skipSpaces(state);
+        if (state.position != text.size()) return false;
+
+        program = std::move(state.program);
+        maxArgument = state.maxArgument;
+        return true;
+    }
+
+    // 求值：$n 取 values[base + n - 1]，scratch 为复用的运算栈
+    double evaluate(const Program& program, const std::vector<double>& values, size_t base, std::vector<double>& scratch) {
+        scratch.clear();
+        for (const Instruction& instruction : program) {
+            switch (instruction.op) {
+                case OpCode::PushConstant:
+                    scratch.push_back(instruction.constant);
+                    break;
+                case OpCode::PushArgument:
+                    scratch.push_back(values[base + instruction.argument - 1]);
+                    break;
+                case OpCode::Negate:
+                    scratch.back() = -scratch.back();
+                    break;
+                default: {
+                    double right = scratch.back();
+                    scratch.pop_back();
+                    double& left = scratch.back();
+                    if (instruction.op == OpCode::Add) left += right;
+                    else if (instruction.op == OpCode::Subtract) left -= right;
+                    else if (instruction.op == OpCode::Multiply) left *= right;
+                    else if (instruction.op == OpCode::Divide) left /= right;
+                    else left = std::fmod(left, right);
+                    break;
+                }
+            }
+        }
+        return scratch.back();
+    }
+}
 
 // 语法解析命名空间 - 用于读取和解析语法文件
 namespace Grammar_SLR1 {
@@ -20,6 +197,22 @@ namespace Grammar_SLR1 {
     std::vector<std::string> productionLeftSides;
     std::vector<std::vector<std::string>> productionRightSides;
 
+    // 运算符优先级与结合性（%left / %right / %nonassoc 声明，越靠后声明的优先级越高）
+    GrammarPrecedence::PrecedenceTable terminalPrecedence;
+    std::map<int, std::string> productionPrecedenceSymbols; // 产生式序号 -> %prec 指定的符号
+
+    // 语义动作：产生式序号 -> 编译后的表达式及其原文
+    std::map<int, SemanticAction_SLR1::Program> productionActions;
+    std::map<int, std::string> productionActionTexts;
+
+    // 开始符号（%start 声明，可有多个入口）；每个开始符号 X 对应一条拓广产生式 X' -> X，
+    // 依次排在产生式列表最前面，序号与 startSymbols 中的下标一致
+    std::vector<std::string> startSymbols;
+    int augmentedProductionCount = 0;
+
+    // 移入-归约冲突的裁决结果
+    using ConflictResolution = GrammarPrecedence::ConflictResolution;
+
     // 去除字符串首尾的空白字符
     std::string trimWhitespace(const std::string& inputString) {
         size_t startPos = inputString.find_first_not_of(" \t\r\n");
@@ -45,6 +238,51 @@ namespace Grammar_SLR1 {
         return symbol == "epsilon" || symbol == "ε";
     }
 
+    // 产生式右部的实际长度（不计ε），即归约时弹出的符号数和 $n 的上界
+    int rightSideLength(const std::vector<std::string>& rightSide) {
+        return std::count_if(rightSide.begin(), rightSide.end(),
+                             [](const std::string& symbol) { return !isEpsilon(symbol); });
+    }
+
+    // 解析开始符号声明行，如 "%start E T"；不是声明行时返回 false
+    bool parseStartDeclaration(const std::string& line) {
+        std::istringstream lineStream(line);
+        std::string keyword;
+        lineStream >> keyword;
+        if (keyword != "%start") return false;
+
+        std::string symbol;
+        while (lineStream >> symbol) {
+            if (std::find(startSymbols.begin(), startSymbols.end(), symbol) == startSymbols.end()) {
+                startSymbols.push_back(symbol);
+            }
+        }
+        return true;
+    }
+
+    // 取出可选项末尾的语义动作 "{ 表达式 }"；花括号内不是合法表达式时视为普通文法符号
+    bool extractSemanticAction(std::string& alternativeRule, std::string& actionText,
+                               SemanticAction_SLR1::Program& program, int& maxArgument) {
+        if (alternativeRule.empty() || alternativeRule.back() != '}') return false;
+
+        size_t openPosition = alternativeRule.rfind('{');
+        if (openPosition == std::string::npos) return false;
+
+        std::string text = trimWhitespace(alternativeRule.substr(openPosition + 1, alternativeRule.size() - openPosition - 2));
+        if (!SemanticAction_SLR1::compile(text, program, maxArgument)) return false;
+
+        actionText = text;
+        alternativeRule = trimWhitespace(alternativeRule.substr(0, openPosition));
+        return true;
+    }
+
+    // 按 Yacc 规则裁决"按产生式归约"与"移入终结符"之间的冲突
+    ConflictResolution resolveShiftReduce(int productionIndex, const std::string& terminal) {
+        auto overrideIter = productionPrecedenceSymbols.find(productionIndex);
+        return GrammarPrecedence::resolveShiftReduce(productionRightSides[productionIndex],
+            overrideIter == productionPrecedenceSymbols.end() ? "" : overrideIter->second, terminal, terminalPrecedence);
+    }
+
     // 解析产生式右部
     std::vector<std::string> parseRightHandSide(const std::string& rhs) {
         std::vector<std::string> symbols;
@@ -128,6 +366,12 @@ namespace Grammar_SLR1 {
         allSymbols.clear();
         productionLeftSides.clear();
         productionRightSides.clear();
+        terminalPrecedence.clear();
+        productionPrecedenceSymbols.clear();
+        productionActions.clear();
+        productionActionTexts.clear();
+        startSymbols.clear();
+        augmentedProductionCount = 0;
 
         // 临时存储原始产生式规则
         std::vector<std::pair<std::string, std::string>> rawProductionRules;
@@ -147,6 +391,11 @@ namespace Grammar_SLR1 {
                 continue;
             }
 
+            // 优先级声明和开始符号声明
+            if (GrammarPrecedence::parseDeclaration(currentLine, terminalPrecedence) || parseStartDeclaration(currentLine)) {
+                continue;
+            }
+
             // 查找产生式分隔符 " -> "
             size_t arrowPosition = currentLine.find(" -> ");
             if (arrowPosition == std::string::npos) {
@@ -172,12 +421,26 @@ namespace Grammar_SLR1 {
             throw std::runtime_error("No valid production rules found in grammar");
         }
 
-        // 总是添加拓广文法的开始符号
-        if (!startSymbol.empty()) {
-            std::string augmentedStartSymbol = startSymbol + "'";
-            rawProductionRules.insert(rawProductionRules.begin(), { augmentedStartSymbol, startSymbol });
-            std::cout << "SLR1: Added augmented start production: " << augmentedStartSymbol << " -> " << startSymbol << std::endl;
+        // 未声明 %start 时以第一个产生式的左部作为开始符号
+        if (startSymbols.empty()) {
+            startSymbols.push_back(startSymbol);
+        }
+
+        // 为每个开始符号添加拓广产生式，所有入口共用同一个自动机
+        std::vector<std::pair<std::string, std::string>> augmentedRules;
+        for (const std::string& symbol : startSymbols) {
+            bool hasProduction = std::any_of(rawProductionRules.begin(), rawProductionRules.end(),
+                [&symbol](const auto& rule) { return rule.first == symbol; });
+            if (!hasProduction) {
+                throw std::runtime_error("Start symbol has no production: " + symbol);
+            }
+
+            std::string augmentedStartSymbol = symbol + "'";
+            augmentedRules.emplace_back(augmentedStartSymbol, symbol);
+            std::cout << "SLR1: Added augmented start production: " << augmentedStartSymbol << " -> " << symbol << std::endl;
         }
+        rawProductionRules.insert(rawProductionRules.begin(), augmentedRules.begin(), augmentedRules.end());
+        augmentedProductionCount = augmentedRules.size();
 
         // 处理每个产生式
         std::set<std::string> nonterminalSet;
@@ -201,10 +464,39 @@ namespace Grammar_SLR1 {
                 alternativeRule = trimWhitespace(alternativeRule);
                 if (alternativeRule.empty()) continue;
 
+                std::string actionText;
+                SemanticAction_SLR1::Program actionProgram;
+                int maxArgument = 0;
+                bool hasAction = extractSemanticAction(alternativeRule, actionText, actionProgram, maxArgument);
+
+                std::string precedenceSymbol = GrammarPrecedence::extractOverride(alternativeRule);
                 std::vector<std::string> symbols = parseRightHandSide(alternativeRule);
 
+                // 只有语义动作的可选项视为 epsilon 产生式
+                if (symbols.empty() && hasAction) symbols.push_back("ε");
                 if (symbols.empty()) continue;
 
+                // ε 与其他符号混写时（如 "a ε"）去掉 ε，全为 ε 时规范为单个 ε，
+                // 保证项目集、归约弹栈和值栈只看到 {ε} 或不含 ε 的右部
+                int symbolCount = rightSideLength(symbols);
+                if (symbolCount == 0) {
+                    symbols.assign(1, "ε");
+                } else if (symbolCount < symbols.size()) {
+                    symbols.erase(std::remove_if(symbols.begin(), symbols.end(), isEpsilon), symbols.end());
+                }
+
+                if (hasAction) {
+                    if (maxArgument > symbolCount) {
+                        throw std::runtime_error("Semantic action refers to $" + std::to_string(maxArgument) +
+                                                 " but production has " + std::to_string(symbolCount) +
+                                                 " symbols: " + productionPair.first + " -> " + alternativeRule);
+                    }
+                    productionActions[productionLeftSides.size()] = std::move(actionProgram);
+                    productionActionTexts[productionLeftSides.size()] = actionText;
+                }
+                if (!precedenceSymbol.empty()) {
+                    productionPrecedenceSymbols[productionLeftSides.size()] = precedenceSymbol;
+                }
                 productionLeftSides.push_back(productionPair.first);
                 productionRightSides.push_back(symbols);
             }
@@ -320,11 +612,12 @@ namespace ItemSet_SLR1 {
     std::vector<std::set<LRItem>> computeCanonicalCollection() {
         std::vector<std::set<LRItem>> collection;
 
-        // 初始项目集 - 假设第一个产生式是增广文法的开始产生式
-        std::set<LRItem> initialSet;
-        initialSet.insert({0, 0});
-        std::set<LRItem> initialClosure = computeClosure(initialSet);
-        collection.push_back(initialClosure);
+        // 初始项目集 - 每条拓广产生式对应一个入口状态，状态编号与开始符号下标一致
+        for (int i = 0; i < Grammar_SLR1::augmentedProductionCount; ++i) {
+            std::set<LRItem> initialSet;
+            initialSet.insert({i, 0});
+            collection.push_back(computeClosure(initialSet));
+        }
 
         bool hasChanges = true;
         while (hasChanges) {
@@ -376,14 +669,77 @@ namespace SLR1Parser {
     std::map<std::string, std::set<std::string>> firstSets;
     std::map<std::string, std::set<std::string>> followSets;
 
+    // 单产生式归约链：在状态 t 上执行 GOTO(B) 后、向前看符号为 a 时，
+    // 连续发生的 A -> B 类归约被折叠为一次跳转，unitChainTable[t][{B, a}] 记录最终状态
+    struct UnitChain {
+        int targetState;
+        std::string leftSide;                 // 链末端产生式的左部，即最终压入符号栈的符号
+        std::vector<int> skippedProductions;  // 被跳过的产生式（按原执行顺序）
+    };
+    std::vector<std::map<std::pair<std::string, std::string>, UnitChain>> unitChainTable;
+
+    // 通过 registerSemanticAction 注册的C++回调，优先于文法中的表达式动作
+    std::map<int, SemanticCallback> semanticCallbacks;
+
+    bool hasSemanticAction(int productionIndex) {
+        return Grammar_SLR1::productionActions.count(productionIndex) > 0 || semanticCallbacks.count(productionIndex) > 0;
+    }
+
+    // 计算产生式左部的语义值：$1..$n 为 values[base..]，无动作时默认 $$ = $1（epsilon产生式为0）
+    double computeSemanticValue(int productionIndex, const std::vector<double>& values, size_t base,
+                                std::vector<double>& scratch) {
+        auto callbackIter = semanticCallbacks.find(productionIndex);
+        if (callbackIter != semanticCallbacks.end()) {
+            scratch.assign(values.begin() + base, values.end());
+            return callbackIter->second(scratch);
+        }
+
+        auto actionIter = Grammar_SLR1::productionActions.find(productionIndex);
+        if (actionIter != Grammar_SLR1::productionActions.end()) {
+            return SemanticAction_SLR1::evaluate(actionIter->second, values, base, scratch);
+        }
+
+        return base < values.size() ? values[base] : 0;
+    }
+
+    // 判断是否为可消除的单产生式（右部只有一个非终结符，且不是拓广开始产生式；
+    // 带语义动作的产生式会改变语义值，不能跳过）
+    bool isUnitProduction(int productionIndex) {
+        if (productionIndex < Grammar_SLR1::augmentedProductionCount) return false;
+        if (hasSemanticAction(productionIndex)) return false;
+        const std::vector<std::string>& rightSide = Grammar_SLR1::productionRightSides[productionIndex];
+        return rightSide.size() == 1 && Grammar_SLR1::isNonterminal(rightSide[0]);
+    }
+
+    // 格式化产生式，如 "E->T"
+    std::string formatProduction(int productionIndex) {
+        std::string text = Grammar_SLR1::productionLeftSides[productionIndex] + "->";
+        for (const std::string& symbol : Grammar_SLR1::productionRightSides[productionIndex]) {
+            text += symbol;
+        }
+        return text;
+    }
+
+    // 读取文法并计算FIRST/FOLLOW集合，旧的项目集族和分析表作废
+    void loadGrammar(const std::string& grammarContent) {
+        Grammar_SLR1::parseGrammar(grammarContent);
+
+        canonicalCollection.clear();
+        actionTable.clear();
+        gotoTable.clear();
+        unitChainTable.clear();
+        semanticCallbacks.clear(); // 产生式序号随文法变化，旧回调失效
+
+        firstSets = computeFirstSets();
+        followSets = computeFollowSets();
+    }
+
     // 从字符串读取语法
     void readGrammarFromString(const std::string& grammarContent) {
-        Grammar_SLR1::parseGrammar(grammarContent);
+        loadGrammar(grammarContent);
         
         // 重新计算项目集族和分析表
         canonicalCollection = ItemSet_SLR1::computeCanonicalCollection();
-        firstSets = computeFirstSets();
-        followSets = computeFollowSets();
         
         // 构建SLR1分析表
         actionTable.clear();
@@ -405,6 +761,7 @@ namespace SLR1Parser {
         for (int i = 0; i < canonicalCollection.size(); ++i) {
             const std::set<ItemSet_SLR1::LRItem>& itemSet = canonicalCollection[i];
             std::cout << "Building table for state " << i << std::endl;
+            std::set<std::string> nonassocErrors; // 因 %nonassoc 被置为错误的终结符，后续不再填写
 
             for (const ItemSet_SLR1::LRItem& item : itemSet) {
                 const std::vector<std::string>& production = Grammar_SLR1::productionRightSides[item.productionIndex];
@@ -416,15 +773,11 @@ namespace SLR1Parser {
                 if (item.dotPosition == production.size()) std::cout << ". ";
                 std::cout << std::endl;
 
-                if (item.dotPosition < production.size()) {
+                // A -> .ε 等同于归约项目 A -> ε.
+                if (item.dotPosition < production.size() && !Grammar_SLR1::isEpsilon(production[item.dotPosition])) {
                     // 移入项目
                     std::string nextSymbol = production[item.dotPosition];
                     
-                    // 如果下一个符号是epsilon，不进行状态转移
-                    if (Grammar_SLR1::isEpsilon(nextSymbol)) {
-                        continue;
-                    }
-                    
                     std::set<ItemSet_SLR1::LRItem> gotoSet = ItemSet_SLR1::computeGoto(canonicalCollection[i], nextSymbol);
 
                     if (!gotoSet.empty()) {
@@ -437,7 +790,23 @@ namespace SLR1Parser {
                                                            nextSymbol) != Grammar_SLR1::terminalSymbols.end();
                                 
                                 if (isTerminal) {
-                                    actionTable[i][nextSymbol] = "s" + std::to_string(j);
+                                    // 已有归约动作时按优先级裁决，无优先级信息则保持移入覆盖
+                                    std::string& existingAction = actionTable[i][nextSymbol];
+                                    Grammar_SLR1::ConflictResolution resolution = Grammar_SLR1::ConflictResolution::Unresolved;
+                                    if (!existingAction.empty() && existingAction[0] == 'r') {
+                                        resolution = Grammar_SLR1::resolveShiftReduce(std::stoi(existingAction.substr(1)), nextSymbol);
+                                    }
+
+                                    if (nonassocErrors.count(nextSymbol) > 0 ||
+                                        resolution == Grammar_SLR1::ConflictResolution::Reduce) {
+                                        std::cout << "      Keep ACTION[" << i << "][" << nextSymbol << "] = " << existingAction << " by precedence" << std::endl;
+                                    } else if (resolution == Grammar_SLR1::ConflictResolution::Error) {
+                                        std::cout << "      Nonassoc conflict at state " << i << " symbol " << nextSymbol << ", set error" << std::endl;
+                                        existingAction = "";
+                                        nonassocErrors.insert(nextSymbol);
+                                    } else {
+                                        existingAction = "s" + std::to_string(j);
+                                    }
                                 } else {
                                     gotoTable[i][nextSymbol] = j;
                                 }
@@ -451,7 +820,7 @@ namespace SLR1Parser {
                     std::cout << "    Reduce item, left side: " << leftSide << ", production index: " << item.productionIndex << std::endl;
                     
                     // 检查是否是接受项目：S' -> S.
-                    if (leftSide.find("'") != std::string::npos && item.productionIndex == 0) {
+                    if (item.productionIndex < Grammar_SLR1::augmentedProductionCount) {
                         // 接受项目
                         std::cout << "    Setting accept action for state " << i << std::endl;
                         actionTable[i]["#"] = "acc";
@@ -466,9 +835,23 @@ namespace SLR1Parser {
                             }
                             std::cout << std::endl;
                             for (const std::string& followSymbol : followSets[leftSide]) {
-                                if (actionTable[i][followSymbol].empty()) {
-                                    actionTable[i][followSymbol] = "r" + std::to_string(item.productionIndex);
+                                if (nonassocErrors.count(followSymbol) > 0) continue;
+
+                                std::string& existingAction = actionTable[i][followSymbol];
+                                Grammar_SLR1::ConflictResolution resolution = Grammar_SLR1::ConflictResolution::Unresolved;
+                                if (!existingAction.empty() && existingAction[0] == 's') {
+                                    resolution = Grammar_SLR1::resolveShiftReduce(item.productionIndex, followSymbol);
+                                }
+
+                                if (existingAction.empty() || resolution == Grammar_SLR1::ConflictResolution::Reduce) {
+                                    existingAction = "r" + std::to_string(item.productionIndex);
                                     std::cout << "      Set ACTION[" << i << "][" << followSymbol << "] = r" << item.productionIndex << std::endl;
+                                } else if (resolution == Grammar_SLR1::ConflictResolution::Shift) {
+                                    std::cout << "      Keep ACTION[" << i << "][" << followSymbol << "] = " << existingAction << " by precedence" << std::endl;
+                                } else if (resolution == Grammar_SLR1::ConflictResolution::Error) {
+                                    std::cout << "      Nonassoc conflict at state " << i << " symbol " << followSymbol << ", set error" << std::endl;
+                                    existingAction = "";
+                                    nonassocErrors.insert(followSymbol);
                                 } else {
                                     std::cout << "Warning: SLR1 conflict at state " << i 
                                              << " symbol " << followSymbol << std::endl;
@@ -479,6 +862,123 @@ namespace SLR1Parser {
                 }
             }
         }
+
+        eliminateUnitReductions();
+    }
+
+    // 文法数据的快照：构造时保存 Grammar_SLR1 与 FIRST/FOLLOW 集合，析构时恢复（异常退出时同样恢复）
+    struct GrammarStateGuard {
+        std::vector<std::string> nonterminalSymbols = Grammar_SLR1::nonterminalSymbols;
+        std::vector<std::string> terminalSymbols = Grammar_SLR1::terminalSymbols;
+        std::vector<std::string> allSymbols = Grammar_SLR1::allSymbols;
+        std::vector<std::string> productionLeftSides = Grammar_SLR1::productionLeftSides;
+        std::vector<std::vector<std::string>> productionRightSides = Grammar_SLR1::productionRightSides;
+        GrammarPrecedence::PrecedenceTable terminalPrecedence = Grammar_SLR1::terminalPrecedence;
+        std::map<int, std::string> productionPrecedenceSymbols = Grammar_SLR1::productionPrecedenceSymbols;
+        std::map<int, SemanticAction_SLR1::Program> productionActions = Grammar_SLR1::productionActions;
+        std::map<int, std::string> productionActionTexts = Grammar_SLR1::productionActionTexts;
+        std::vector<std::string> startSymbols = Grammar_SLR1::startSymbols;
+        int augmentedProductionCount = Grammar_SLR1::augmentedProductionCount;
+        std::map<std::string, std::set<std::string>> savedFirstSets = firstSets;
+        std::map<std::string, std::set<std::string>> savedFollowSets = followSets;
+
+        ~GrammarStateGuard() {
+            Grammar_SLR1::nonterminalSymbols = std::move(nonterminalSymbols);
+            Grammar_SLR1::terminalSymbols = std::move(terminalSymbols);
+            Grammar_SLR1::allSymbols = std::move(allSymbols);
+            Grammar_SLR1::productionLeftSides = std::move(productionLeftSides);
+            Grammar_SLR1::productionRightSides = std::move(productionRightSides);
+            Grammar_SLR1::terminalPrecedence = std::move(terminalPrecedence);
+            Grammar_SLR1::productionPrecedenceSymbols = std::move(productionPrecedenceSymbols);
+            Grammar_SLR1::productionActions = std::move(productionActions);
+            Grammar_SLR1::productionActionTexts = std::move(productionActionTexts);
+            Grammar_SLR1::startSymbols = std::move(startSymbols);
+            Grammar_SLR1::augmentedProductionCount = augmentedProductionCount;
+            firstSets = std::move(savedFirstSets);
+            followSets = std::move(savedFollowSets);
+        }
+    };
+
+    // 仅读取文法并计算FIRST/FOLLOW集合，不构建LR自动机；SLR1当前的文法和分析表保持不变
+    GrammarAnalysis analyzeGrammar(const std::string& grammarContent) {
+        GrammarStateGuard guard;
+
+        Grammar_SLR1::parseGrammar(grammarContent);
+        firstSets = computeFirstSets();
+        followSets = computeFollowSets();
+
+        GrammarAnalysis analysis;
+        analysis.productionLeftSides = Grammar_SLR1::productionLeftSides;
+        analysis.productionRightSides = Grammar_SLR1::productionRightSides;
+        analysis.startSymbols = Grammar_SLR1::startSymbols;
+        analysis.terminalSymbols = Grammar_SLR1::terminalSymbols;
+        analysis.nonterminalSymbols = Grammar_SLR1::nonterminalSymbols;
+        analysis.firstSets = firstSets;
+        analysis.followSets = followSets;
+        return analysis;
+    }
+
+    // 单产生式归约消除：对每个 (状态, 非终结符, 向前看符号) 预先沿单产生式归约链走到底
+    void eliminateUnitReductions() {
+        unitChainTable.clear();
+        unitChainTable.resize(gotoTable.size());
+
+        for (int state = 0; state < gotoTable.size(); ++state) {
+            for (const auto& [nonterminal, firstGoto] : gotoTable[state]) {
+                if (firstGoto == -1) continue;
+
+                for (const std::string& terminal : Grammar_SLR1::terminalSymbols) {
+                    UnitChain chain;
+                    chain.targetState = firstGoto;
+                    chain.leftSide = nonterminal;
+
+                    // 链长不会超过非终结符个数，超过说明存在 A -> B -> A 这样的循环
+                    while (chain.skippedProductions.size() <= Grammar_SLR1::nonterminalSymbols.size()) {
+                        auto actionIter = actionTable[chain.targetState].find(terminal);
+                        if (actionIter == actionTable[chain.targetState].end() ||
+                            actionIter->second.empty() || actionIter->second[0] != 'r') {
+                            break;
+                        }
+
+                        int productionIndex = std::stoi(actionIter->second.substr(1));
+                        if (!isUnitProduction(productionIndex)) break;
+
+                        // 归约 A -> B 只弹出一个状态，栈顶重新回到 state
+                        const std::string& leftSide = Grammar_SLR1::productionLeftSides[productionIndex];
+                        int nextState = gotoTable[state][leftSide];
+                        if (nextState == -1) break;
+
+                        chain.skippedProductions.push_back(productionIndex);
+                        chain.targetState = nextState;
+                        chain.leftSide = leftSide;
+                    }
+
+                    if (!chain.skippedProductions.empty()) {
+                        unitChainTable[state][{nonterminal, terminal}] = chain;
+                    }
+                }
+            }
+        }
+
+        std::cout << "SLR1: Unit reduction chains: " << std::accumulate(unitChainTable.begin(), unitChainTable.end(), 0,
+            [](int total, const auto& chains) { return total + static_cast<int>(chains.size()); }) << std::endl;
+    }
+
+    // 注册语义动作回调（须在读取文法之后调用）
+    void registerSemanticAction(int productionIndex, const SemanticCallback& callback) {
+        if (productionIndex < Grammar_SLR1::augmentedProductionCount ||
+            productionIndex >= static_cast<int>(Grammar_SLR1::productionLeftSides.size())) {
+            throw std::runtime_error("Invalid production index for semantic action: " + std::to_string(productionIndex));
+        }
+        semanticCallbacks[productionIndex] = callback;
+
+        // 带动作的单产生式不能再被跳过
+        if (!gotoTable.empty()) eliminateUnitReductions();
+    }
+
+    void clearSemanticActions() {
+        semanticCallbacks.clear();
+        if (!gotoTable.empty()) eliminateUnitReductions();
     }
 
     // 从文件读取语法
@@ -505,6 +1005,33 @@ namespace SLR1Parser {
         return Grammar_SLR1::productionRightSides;
     }
 
+    // 获取开始符号（入口状态编号即其下标）
+    std::vector<std::string> getStartSymbols() {
+        return Grammar_SLR1::startSymbols;
+    }
+
+    // 获取终结符（含结束符#）和非终结符（含拓广开始符号）
+    std::vector<std::string> getTerminalSymbols() {
+        return Grammar_SLR1::terminalSymbols;
+    }
+
+    std::vector<std::string> getNonterminalSymbols() {
+        return Grammar_SLR1::nonterminalSymbols;
+    }
+
+    // 获取最近一次计算的FIRST/FOLLOW集合
+    std::map<std::string, std::set<std::string>> getFirstSets() {
+        return firstSets;
+    }
+
+    std::map<std::string, std::set<std::string>> getFollowSets() {
+        return followSets;
+    }
+
+    bool isEpsilon(const std::string& symbol) {
+        return Grammar_SLR1::isEpsilon(symbol);
+    }
+
     // 计算FIRST集合
     std::map<std::string, std::set<std::string>> computeFirstSets() {
         std::map<std::string, std::set<std::string>> first;
@@ -572,15 +1099,10 @@ namespace SLR1Parser {
             follow[nonterminal] = std::set<std::string>();
         }
 
-        // 开始符号的FOLLOW集合包含#
-        // 注意：在拓广文法中，原开始符号是第二个产生式的左部
-        std::string originalStartSymbol = "";
-        if (Grammar_SLR1::productionLeftSides.size() > 1) {
-            originalStartSymbol = Grammar_SLR1::productionLeftSides[1];  // 第二个产生式的左部是原开始符号
-        }
-        if (!originalStartSymbol.empty()) {
-            follow[originalStartSymbol].insert("#");
-            std::cout << "Set FOLLOW(" << originalStartSymbol << ") to include #" << std::endl;
+        // 每个开始符号的FOLLOW集合都包含#
+        for (const std::string& startSymbol : Grammar_SLR1::startSymbols) {
+            follow[startSymbol].insert("#");
+            std::cout << "Set FOLLOW(" << startSymbol << ") to include #" << std::endl;
         }
 
         bool changed = true;
@@ -672,6 +1194,7 @@ namespace SLR1Parser {
         // 设置其他信息
         result.firstSets = firstSets;
         result.followSets = followSets;
+        result.startSymbols = Grammar_SLR1::startSymbols;
 
         // 构建产生式信息
         std::map<std::string, std::vector<std::vector<std::string>>> productionMap;
@@ -687,6 +1210,12 @@ namespace SLR1Parser {
             prod.index = i;
             prod.leftSide = Grammar_SLR1::productionLeftSides[i];
             prod.rightSide = Grammar_SLR1::productionRightSides[i];
+            auto actionTextIter = Grammar_SLR1::productionActionTexts.find(i);
+            if (semanticCallbacks.count(i) > 0) {
+                prod.semanticAction = "<callback>";
+            } else if (actionTextIter != Grammar_SLR1::productionActionTexts.end()) {
+                prod.semanticAction = actionTextIter->second;
+            }
             result.productionList.push_back(prod);
         }
 
@@ -700,7 +1229,7 @@ namespace SLR1Parser {
     }
 
     // 解析输入字符串（使用已构建的解析表）
-    ParseResult parseInput(const std::string& input) {
+    ParseResult parseInput(const std::string& input, const ParseOptions& options) {
         ParseResult result;
         result.success = false;
         result.isAccepted = false;
@@ -732,6 +1261,7 @@ namespace SLR1Parser {
         // 设置其他信息
         result.firstSets = firstSets;
         result.followSets = followSets;
+        result.startSymbols = Grammar_SLR1::startSymbols;
 
         // 构建产生式信息
         std::map<std::string, std::vector<std::vector<std::string>>> productionMap;
@@ -747,27 +1277,66 @@ namespace SLR1Parser {
             prod.index = i;
             prod.leftSide = Grammar_SLR1::productionLeftSides[i];
             prod.rightSide = Grammar_SLR1::productionRightSides[i];
+            auto actionTextIter = Grammar_SLR1::productionActionTexts.find(i);
+            if (semanticCallbacks.count(i) > 0) {
+                prod.semanticAction = "<callback>";
+            } else if (actionTextIter != Grammar_SLR1::productionActionTexts.end()) {
+                prod.semanticAction = actionTextIter->second;
+            }
             result.productionList.push_back(prod);
         }
 
         // 生成DOT文件内容
         result.dotFile = generateDotFile();
 
-        // 准备输入串
+        // 文法带语义动作或注册了回调时才计算语义值
+        bool semanticEnabled = !Grammar_SLR1::productionActions.empty() || !semanticCallbacks.empty();
+
+        // 准备输入串；文法带语义动作时 "终结符:数值" 形式的记号携带语义值，纯数字记号的语义值为其自身，
+        // 否则记号原样作为终结符（可以含 ':'）
         std::vector<std::string> inputTokens;
+        std::vector<double> tokenValues;
         std::istringstream iss(input);
         std::string token;
         while (iss >> token) {
+            double tokenValue = 0;
+            size_t colonPosition = token.rfind(':');
+            if (!semanticEnabled) {
+                // 不需要语义值
+            } else if (colonPosition != std::string::npos && colonPosition > 0 &&
+                SemanticAction_SLR1::parseNumber(token.substr(colonPosition + 1), tokenValue)) {
+                token = token.substr(0, colonPosition);
+            } else if (!SemanticAction_SLR1::parseNumber(token, tokenValue)) {
+                tokenValue = 0;
+            }
             inputTokens.push_back(token);
+            tokenValues.push_back(tokenValue);
         }
         inputTokens.push_back("#");
+        tokenValues.push_back(0);
+
+        // 选择入口状态：未指定时使用第一个开始符号
+        int entryState = 0;
+        if (!options.startSymbol.empty()) {
+            auto startIter = std::find(Grammar_SLR1::startSymbols.begin(), Grammar_SLR1::startSymbols.end(), options.startSymbol);
+            if (startIter == Grammar_SLR1::startSymbols.end()) {
+                result.message = "未声明的开始符号: " + options.startSymbol;
+                return result;
+            }
+            entryState = startIter - Grammar_SLR1::startSymbols.begin();
+        }
 
         // 初始化分析栈
         std::vector<int> stateStack;
         std::vector<std::string> symbolStack;
-        stateStack.push_back(0);
+        stateStack.push_back(entryState);
         symbolStack.push_back("#");
 
+        // 值栈与状态栈同步伸缩，归约时就地计算语义值，不构建语法树
+        std::vector<double> valueStack;
+        std::vector<double> scratch;
+        valueStack.push_back(0);
+
         int inputIndex = 0;
         int step = 0;
 
@@ -801,6 +1370,14 @@ namespace SLR1Parser {
             }
             parseStep.remainingInput = remainingInputStr.str();
 
+            if (semanticEnabled) {
+                std::ostringstream valueStackStr;
+                for (size_t i = 1; i < valueStack.size(); ++i) {
+                    valueStackStr << valueStack[i] << " ";
+                }
+                parseStep.valueStack = valueStackStr.str();
+            }
+
             // 查找动作
             if (actionTable[currentState].find(currentSymbol) == actionTable[currentState].end()) {
                 parseStep.action = "错误";
@@ -840,6 +1417,10 @@ namespace SLR1Parser {
                 result.isAccepted = true;
                 result.success = true;
                 result.message = "输入被接受";
+                if (semanticEnabled) {
+                    result.hasSemanticValue = true;
+                    result.semanticValue = valueStack.back();
+                }
                 break;
             } else if (action.empty()) {
                 result.message = "分析错误：空动作";
@@ -850,6 +1431,7 @@ namespace SLR1Parser {
                 int nextState = std::stoi(action.substr(1));
                 stateStack.push_back(nextState);
                 symbolStack.push_back(currentSymbol);
+                valueStack.push_back(tokenValues[inputIndex]);
                 inputIndex++;
             } else if (action[0] == 'r') {
                 // 归约动作
@@ -857,12 +1439,14 @@ namespace SLR1Parser {
                 std::string leftSide = Grammar_SLR1::productionLeftSides[productionIndex];
                 std::vector<std::string> rightSide = Grammar_SLR1::productionRightSides[productionIndex];
 
-                // 弹出栈 - 特殊处理epsilon产生式
-                int symbolsToReduce = rightSide.size();
-                if (rightSide.size() == 1 && Grammar_SLR1::isEpsilon(rightSide[0])) {
-                    symbolsToReduce = 0;  // epsilon产生式不弹出任何符号
-                }
+                // 弹出栈 - epsilon产生式不弹出任何符号
+                int symbolsToReduce = Grammar_SLR1::rightSideLength(rightSide);
                 
+                size_t valueBase = valueStack.size() - symbolsToReduce;
+                double reducedValue = computeSemanticValue(productionIndex, valueStack, valueBase, scratch);
+                valueStack.resize(valueBase);
+                valueStack.push_back(reducedValue);
+
                 for (int i = 0; i < symbolsToReduce; i++) {
                     if (!stateStack.empty()) stateStack.pop_back();
                     if (!symbolStack.empty()) symbolStack.pop_back();
@@ -870,8 +1454,30 @@ namespace SLR1Parser {
 
                 // GOTO操作
                 int gotoState = gotoTable[stateStack.back()][leftSide];
+                std::string gotoSymbol = leftSide;
+
+                // 跳过随后的单产生式归约链，直接到达最终GOTO状态
+                if (options.eliminateUnitReductions) {
+                    auto chainIter = unitChainTable[stateStack.back()].find({leftSide, currentSymbol});
+                    if (chainIter != unitChainTable[stateStack.back()].end()) {
+                        const UnitChain& chain = chainIter->second;
+                        gotoState = chain.targetState;
+                        gotoSymbol = chain.leftSide;
+
+                        ParseStep& lastStep = result.parseSteps.back();
+                        lastStep.bypassedProductions = chain.skippedProductions;
+                        lastStep.action += " (bypass ";
+                        for (int i = 0; i < chain.skippedProductions.size(); ++i) {
+                            if (i > 0) lastStep.action += ", ";
+                            lastStep.action += formatProduction(chain.skippedProductions[i]);
+                        }
+                        lastStep.action += ")";
+                        result.bypassedReductionCount += chain.skippedProductions.size();
+                    }
+                }
+
                 stateStack.push_back(gotoState);
-                symbolStack.push_back(leftSide);
+                symbolStack.push_back(gotoSymbol);
             } else {
                 result.message = "分析错误：未知动作";
                 result.success = true;  // 仍然设置为成功，因为解析表已构建
@@ -974,8 +1580,10 @@ namespace SLR1Parser {
             }
         }
 
-        // 标记初始状态I0
-        dot << "  I0 [style=\"rounded,filled\", fillcolor=lightblue];" << std::endl;
+        // 标记入口状态（每个开始符号一个）
+        for (int i = 0; i < Grammar_SLR1::augmentedProductionCount; ++i) {
+            dot << "  I" << i << " [style=\"rounded,filled\", fillcolor=lightblue];" << std::endl;
+        }
 
         dot << "}" << std::endl;
         return dot.str();
@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <functional>
 
 // 前置声明
 namespace ItemSet_SLR1 {
@@ -19,6 +20,25 @@ namespace SLR1Parser {
     // 获取产生式信息
     std::vector<std::string> getProductionLeftSides();
     std::vector<std::vector<std::string>> getProductionRightSides();
+    std::vector<std::string> getStartSymbols();
+    std::vector<std::string> getTerminalSymbols();
+    std::vector<std::string> getNonterminalSymbols();
+    bool isEpsilon(const std::string& symbol);
+    
+    // 文法分析结果：产生式（含拓广产生式）、符号表与FIRST/FOLLOW集合
+    struct GrammarAnalysis {
+        std::vector<std::string> productionLeftSides;
+        std::vector<std::vector<std::string>> productionRightSides;
+        std::vector<std::string> startSymbols;
+        std::vector<std::string> terminalSymbols;    // 含结束符#
+        std::vector<std::string> nonterminalSymbols; // 含拓广开始符号
+        std::map<std::string, std::set<std::string>> firstSets;
+        std::map<std::string, std::set<std::string>> followSets;
+    };
+
+    // 仅读取文法并计算FIRST/FOLLOW集合（不构建LR自动机），供LL(1)分析器复用；
+    // 不改变SLR1已读取的文法、分析表和语义回调
+    GrammarAnalysis analyzeGrammar(const std::string& grammarContent);
     
     // 解析步骤结构
     struct ParseStep {
@@ -27,6 +47,8 @@ namespace SLR1Parser {
         std::string symbolStack;
         std::string remainingInput;
         std::string action;
+        std::vector<int> bypassedProductions; // 本步归约后被跳过的单产生式（按原执行顺序），用于重建完整轨迹
+        std::string valueStack;               // 语义值栈（文法带语义动作时记录）
     };
     
     // 分析表行结构
@@ -47,6 +69,7 @@ namespace SLR1Parser {
         int index;
         std::string leftSide;
         std::vector<std::string> rightSide;
+        std::string semanticAction; // 语义动作表达式，如 "$1 + $3"
     };
 
     // 解析相关
@@ -61,13 +84,33 @@ namespace SLR1Parser {
         std::vector<Production> productionList; // 新增：按序号排列的产生式列表
         std::map<std::string, std::set<std::string>> firstSets;
         std::map<std::string, std::set<std::string>> followSets;
+        int bypassedReductionCount = 0; // 被跳过的单产生式归约总数
+        std::vector<std::string> startSymbols; // 共用同一自动机的各个开始符号
+        bool hasSemanticValue = false;         // 文法带语义动作且输入被接受时为 true
+        double semanticValue = 0;              // 开始符号的语义值
+    };
+    
+    // 解析选项
+    struct ParseOptions {
+        bool eliminateUnitReductions = false; // 跳过单产生式归约链（如 T -> F、E -> T），直接跳到最终GOTO状态
+        std::string startSymbol;              // 入口开始符号（须由 %start 声明），为空时使用第一个开始符号
     };
     
     // 构建解析表（独立于输入分析）
     ParseResult buildParseTable();
     
     // 解析输入字符串（使用已构建的解析表）
-    ParseResult parseInput(const std::string& input);
+    ParseResult parseInput(const std::string& input, const ParseOptions& options = ParseOptions());
+    
+    // 语义动作回调：参数为产生式右部各符号的语义值（$1..$n），返回左部的语义值
+    using SemanticCallback = std::function<double(const std::vector<double>&)>;
+    
+    // 为产生式注册C++回调（优先于文法中的 "{ 表达式 }" 动作），重新读取文法时清空
+    void registerSemanticAction(int productionIndex, const SemanticCallback& callback);
+    void clearSemanticActions();
+    
+    // 单产生式归约消除（分析表后处理，readGrammarFromString 时自动执行）
+    void eliminateUnitReductions();
     
     // 生成DOT文件
     std::string generateDotFile();
@@ -80,6 +123,8 @@ namespace SLR1Parser {
     // FIRST和FOLLOW集合计算
     std::map<std::string, std::set<std::string>> computeFirstSets();
     std::map<std::string, std::set<std::string>> computeFollowSets();
+    std::map<std::string, std::set<std::string>> getFirstSets();
+    std::map<std::string, std::set<std::string>> getFollowSets();
     
     // 调试和信息输出
     void printGrammar();
@@ -148,8 +148,13 @@ curl -X POST http://localhost:8080/api/regex/match \\
     std::cout << "   GET  /api/health - Health check\n";
     std::cout << "   POST /api/lr0/parse - LR0 syntax analysis\n";
     std::cout << "   POST /api/slr1/parse - SLR1 syntax analysis\n";
+    std::cout << "   POST /api/ll1/parse - LL1 predictive parsing\n";
     std::cout << "   POST /api/regex/build - Build regex automata\n";
     std::cout << "   POST /api/regex/match - Match string with regex\n";
+    std::cout << "   POST /api/regex/match-batch - Match many strings with one regex\n";
+    std::cout << "   POST /api/regex/extract - Extract capture groups with a tagged DFA\n";
+    std::cout << "   POST /api/regex/search - Find all matches in text\n";
+    std::cout << "   POST /api/regex/set - Match input against a set of regexes\n";
     std::cout << "   POST /api/grammar/upload - Upload grammar file\n";
     std::cout << "Documentation: http://localhost:" << port << "\n";
     std::cout << "Press Ctrl+C to stop the server\n\n";
@@ -0,0 +1,216 @@
+// 命令行正则表达式按行搜索：内存映射输入文件，按行边界切块后多线程并行扫描，按文件顺序输出匹配行
+#include "core/regex_automata.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const size_t MIN_CHUNK_SIZE = 1 << 20; // 每块至少 1MB，块太小时线程调度的开销超过扫描本身
+    const int CHUNKS_PER_THREAD = 4;       // 块数多于线程数，各线程负载更均匀
+
+    struct Options {
+        std::string pattern;
+        std::vector<std::string> files;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        bool countOnly = false;   // -c：只输出匹配行数
+        bool byteOffset = false;  // -b：行首加上字节偏移
+        bool quiet = false;       // -q：不输出匹配行，只报告统计
+    };
+
+    // 只读映射整个文件，顺序访问提示内核加大预读
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error(path + ": " + std::strerror(errno));
+            }
+            struct stat info;
+            if (fstat(fd, &info) < 0) {
+                close(fd);
+                throw std::runtime_error(path + ": " + std::strerror(errno));
+            }
+            size = info.st_size;
+            if (size == 0) return;
+
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error(path + ": " + std::strerror(errno));
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapped);
+        }
+
+        ~MappedFile() {
+            if (data) munmap(const_cast<char*>(data), size);
+            if (fd >= 0) close(fd);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data = nullptr;
+        size_t size = 0;
+
+    private:
+        int fd = -1;
+    };
+
+    // 按行边界切块：每块在目标长度之后的第一个换行处结束
+    std::vector<std::pair<size_t, size_t>> splitChunks(const char* data, size_t size, unsigned threads) {
+        size_t target = std::max(MIN_CHUNK_SIZE, size / (threads * CHUNKS_PER_THREAD) + 1);
+        std::vector<std::pair<size_t, size_t>> chunks;
+        size_t begin = 0;
+        while (begin < size) {
+            size_t end = std::min(size, begin + target);
+            if (end < size) {
+                const void* newline = std::memchr(data + end, '\n', size - end);
+                end = newline ? static_cast<const char*>(newline) - data + 1 : size;
+            }
+            chunks.push_back({begin, end});
+            begin = end;
+        }
+        return chunks;
+    }
+
+    // 扫描一个文件，返回匹配行数，bytes 为实际扫描的字节数；输出按文件中的顺序
+    size_t grepFile(const RegexAutomata::LineScanner& scanner, const std::string& path, const Options& options,
+                    bool printName, size_t& bytes) {
+        MappedFile file(path);
+        bytes = file.size;
+        std::vector<std::pair<size_t, size_t>> chunks = splitChunks(file.data, file.size, options.threads);
+        std::vector<std::vector<size_t>> results(chunks.size());
+
+        std::atomic<size_t> nextChunk(0);
+        auto worker = [&]() {
+            for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+                const auto& [begin, end] = chunks[i];
+                results[i] = scanner.matchingLines(file.data + begin, end - begin);
+                for (size_t& line : results[i]) line += begin;
+            }
+        };
+        std::vector<std::thread> workers;
+        unsigned threadCount = std::min<size_t>(options.threads, chunks.size());
+        for (unsigned t = 1; t < threadCount; t++) workers.emplace_back(worker);
+        worker();
+        for (auto& thread : workers) thread.join();
+
+        size_t count = 0;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            count += results[i].size();
+            if (options.countOnly || options.quiet) continue;
+            for (size_t line : results[i]) {
+                const void* newline = std::memchr(file.data + line, '\n', chunks[i].second - line);
+                size_t end = newline ? static_cast<const char*>(newline) - file.data : chunks[i].second;
+                if (printName) std::cout << path << ':';
+                if (options.byteOffset) std::cout << line << ':';
+                std::cout.write(file.data + line, end - line);
+                std::cout << '\n';
+            }
+        }
+        if (options.countOnly) {
+            if (printName) std::cout << path << ':';
+            std::cout << count << '\n';
+        }
+        return count;
+    }
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [-c] [-b] [-q] [-j threads] PATTERN FILE...\n"
+                  << "  PATTERN uses the regex syntax of the API; ^ and $ anchor to the line start/end and are only\n"
+                  << "  allowed at the start/end of a top-level alternative (write \\^ and \\$ for literal characters)\n"
+                  << "  -c  print only the number of matching lines per file\n"
+                  << "  -b  prefix each line with its byte offset\n"
+                  << "  -q  print nothing but the summary\n"
+                  << "  -j  number of scanning threads (default: hardware concurrency)\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-c") {
+            options.countOnly = true;
+        } else if (arg == "-b") {
+            options.byteOffset = true;
+        } else if (arg == "-q") {
+            options.quiet = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() < 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    options.pattern = positional[0];
+    options.files.assign(positional.begin() + 1, positional.end());
+
+    std::ios::sync_with_stdio(false);
+    auto buildStart = std::chrono::steady_clock::now();
+    std::unique_ptr<RegexAutomata::LineScanner> scanner;
+    // 构建过程的日志写在标准输出上，这里丢弃，标准输出只留给匹配结果
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(nullptr);
+    try {
+        scanner = std::make_unique<RegexAutomata::LineScanner>(options.pattern);
+    } catch (const std::runtime_error& e) {
+        std::cout.rdbuf(stdoutBuffer);
+        std::cout.clear();
+        std::cerr << "regex_grep: invalid pattern: " << e.what() << "\n";
+        return 2;
+    }
+    std::cout.rdbuf(stdoutBuffer);
+    std::cout.clear();
+    auto buildEnd = std::chrono::steady_clock::now();
+
+    size_t totalBytes = 0, totalMatches = 0;
+    bool failed = false;
+    for (const auto& path : options.files) {
+        try {
+            size_t bytes = 0;
+            totalMatches += grepFile(*scanner, path, options, options.files.size() > 1, bytes);
+            totalBytes += bytes;
+        } catch (const std::runtime_error& e) {
+            std::cerr << "regex_grep: " << e.what() << "\n";
+            failed = true;
+        }
+    }
+    std::cout.flush();
+    auto scanEnd = std::chrono::steady_clock::now();
+
+    double buildMs = std::chrono::duration<double, std::milli>(buildEnd - buildStart).count();
+    double seconds = std::chrono::duration<double>(scanEnd - buildEnd).count();
+    std::cerr << "regex_grep: " << totalMatches << " matching lines, " << totalBytes << " bytes in " << seconds
+              << " s (" << (seconds > 0 ? totalBytes / seconds / 1e9 : 0) << " GB/s, " << options.threads
+              << " threads, ";
+    if (scanner->dfaStates() > 0) {
+        std::cerr << scanner->dfaStates() << " DFA states";
+    } else {
+        std::cerr << "NFA simulation per line (DFA over the size limit)";
+    }
+    std::cerr << " built in " << buildMs << " ms)\n";
+
+    if (failed) return 2;
+    return totalMatches > 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+// GrammarPrecedence 的测试：LR0 与 SLR1 共用的优先级声明解析和移入-归约冲突裁决
+#include "core/grammar_precedence.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    int failures = 0;
+
+    void expectResolution(const GrammarPrecedence::PrecedenceTable& table, const std::vector<std::string>& rightSide,
+                          const std::string& overrideSymbol, const std::string& terminal,
+                          GrammarPrecedence::ConflictResolution expected) {
+        if (GrammarPrecedence::resolveShiftReduce(rightSide, overrideSymbol, terminal, table) == expected) return;
+        failures++;
+        std::string production;
+        for (const std::string& symbol : rightSide) production += symbol;
+        std::cerr << "FAIL " << production << " vs " << terminal << "\n";
+    }
+}
+
+int main() {
+    using GrammarPrecedence::ConflictResolution;
+
+    GrammarPrecedence::PrecedenceTable table;
+    for (const char* line : { "%left + -", "%left *", "%right ^", "%nonassoc <" }) {
+        if (!GrammarPrecedence::parseDeclaration(line, table)) {
+            failures++;
+            std::cerr << "FAIL declaration " << line << "\n";
+        }
+    }
+    if (GrammarPrecedence::parseDeclaration("E -> E + E", table) || table.size() != 5) {
+        failures++;
+        std::cerr << "FAIL production line parsed as a declaration\n";
+    }
+
+    expectResolution(table, { "E", "+", "E" }, "", "+", ConflictResolution::Reduce);
+    expectResolution(table, { "E", "+", "E" }, "", "*", ConflictResolution::Shift);
+    expectResolution(table, { "E", "^", "E" }, "", "^", ConflictResolution::Shift);
+    expectResolution(table, { "E", "<", "E" }, "", "<", ConflictResolution::Error);
+    expectResolution(table, { "E", "+", "E" }, "", "a", ConflictResolution::Unresolved);
+
+    // 最右边的终结符跳过 ε；%prec 优先于右部的终结符
+    expectResolution(table, { "E", "*", "E", "ε" }, "", "+", ConflictResolution::Reduce);
+    expectResolution(table, { "E", "-", "epsilon" }, "", "*", ConflictResolution::Shift);
+    expectResolution(table, { "-", "E" }, "^", "*", ConflictResolution::Reduce);
+
+    std::string rule = "- E %prec ^";
+    if (GrammarPrecedence::extractOverride(rule) != "^" || rule != "- E") {
+        failures++;
+        std::cerr << "FAIL %prec extraction: \"" << rule << "\"\n";
+    }
+
+    std::cout << (failures == 0 ? "grammar_precedence_test: all passed\n" : "grammar_precedence_test: failures\n");
+    return failures == 0 ? 0 : 1;
+}
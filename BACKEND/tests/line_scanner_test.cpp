@@ -0,0 +1,81 @@
+// RegexAutomata::LineScanner 的回归测试：用户模式中的 & 和 ~ 是普通字符、^ $ 为行锚点、DFA超限时逐行模拟NFA
+#include "core/regex_automata.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace {
+    int failures = 0;
+
+    // 返回匹配行的内容，便于与期望值比较
+    std::vector<std::string> grep(const std::string& pattern, const std::string& text) {
+        RegexAutomata::LineScanner scanner(pattern);
+        std::vector<std::string> lines;
+        for (size_t start : scanner.matchingLines(text.data(), text.size())) {
+            size_t end = text.find('\n', start);
+            lines.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        }
+        return lines;
+    }
+
+    void expectLines(const std::string& pattern, const std::string& text, const std::vector<std::string>& expected) {
+        std::vector<std::string> actual = grep(pattern, text);
+        if (actual == expected) return;
+        failures++;
+        std::cerr << "FAIL " << pattern << ": got";
+        for (const auto& line : actual) std::cerr << " [" << line << "]";
+        std::cerr << ", expected";
+        for (const auto& line : expected) std::cerr << " [" << line << "]";
+        std::cerr << "\n";
+    }
+
+    void expectRejected(const std::string& pattern) {
+        try {
+            RegexAutomata::LineScanner scanner(pattern);
+        } catch (const std::runtime_error&) {
+            return;
+        }
+        failures++;
+        std::cerr << "FAIL " << pattern << ": expected the pattern to be rejected\n";
+    }
+}
+
+int main() {
+    // 构建过程的日志写在标准输出上
+    std::cout.setstate(std::ios::failbit);
+
+    const std::string text = "AT&T rocks\nlaser\n~user home\nGET /index\nxGET\nfoo timeout\ntimeout bar\n\n$HOME ^up";
+
+    expectLines("AT&T", text, {"AT&T rocks"});
+    expectLines("~user", text, {"~user home"});
+    expectLines("s~u|T&", text, {"AT&T rocks"});
+
+    expectLines("^GET", text, {"GET /index"});
+    expectLines("timeout$", text, {"foo timeout"});
+    expectLines("^timeout|GET$", text, {"xGET", "timeout bar"});
+    expectLines("^$", text, {""});
+    expectLines("\\$HOME|\\^up", text, {"$HOME ^up"});
+    expectLines("[$^]", text, {"$HOME ^up"});
+    expectRejected("a(^b)");
+    expectRejected("a$b");
+    expectRejected("a(");
+
+    // 完整DFA超过规模上限时不报错，逐行模拟NFA
+    const std::string bits = "abbbbbbbbbbbbb\nbbbbbbbbbbbbbb\nbabbbbbbbbbbbbbb\n";
+    const std::vector<std::string> expected = {"abbbbbbbbbbbbb", "babbbbbbbbbbbbbb"};
+    expectLines("(a|b)*a(a|b){13}", bits, expected);
+    size_t limit = RegexAutomata::getDFATransitionLimit();
+    RegexAutomata::setDFATransitionLimit(1000);
+    expectLines("(a|b)*a(a|b){13}", bits, expected);
+    RegexAutomata::LineScanner fallback("(a|b)*a(a|b){13}");
+    if (fallback.dfaStates() != 0) {
+        failures++;
+        std::cerr << "FAIL expected NFA simulation under a 1000-transition limit\n";
+    }
+    RegexAutomata::setDFATransitionLimit(limit);
+
+    std::cout.clear();
+    std::cout << (failures == 0 ? "line_scanner_test: all passed\n" : "line_scanner_test: failures\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// LL1Parser 的回归测试：左递归在建表时静态检测；读取LL(1)文法不影响SLR1已构建的分析表
+#include "core/ll1_parser.h"
+#include "core/slr1_parser.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    int failures = 0;
+
+    void expectParse(const std::string& grammar, const std::string& input, bool accepted,
+                     const std::vector<std::string>& leftRecursive) {
+        LL1Parser::readGrammarFromString(grammar);
+        LL1Parser::ParseResult result = LL1Parser::parseInput(input);
+        if (result.isAccepted == accepted && result.leftRecursiveNonterminals == leftRecursive) return;
+        failures++;
+        std::cerr << "FAIL \"" << input << "\": " << (accepted ? "expected accept" : "expected reject")
+                  << ", " << result.leftRecursiveNonterminals.size() << " left-recursive nonterminals ("
+                  << result.message << ")\n";
+    }
+}
+
+int main() {
+    // 构建过程的日志写在标准输出上
+    std::cout.setstate(std::ios::failbit);
+
+    // 不读入符号连续展开同一非终结符并不是左递归
+    expectParse("S -> A B\nB -> A c\nA -> ε", "c", true, {});
+    expectParse("E -> T A\nA -> + T A | ε\nT -> F B\nB -> * F B | ε\nF -> ( E ) | a", "a + a * a", true, {});
+
+    // 直接左递归与经过可空符号的间接左递归
+    expectParse("E -> E + a | a", "a + a", false, { "E" });
+    expectParse("S -> B S c | d\nB -> ε", "d", false, { "S" });
+    expectParse("S -> A a | b\nA -> S c", "b c a", false, { "A", "S" });
+
+    // LL(1)读取文法之后，SLR1仍使用原来的文法和分析表
+    SLR1Parser::readGrammarFromString("E -> E + n | n");
+    LL1Parser::readGrammarFromString("S -> a S | b");
+    SLR1Parser::ParseResult slr1 = SLR1Parser::parseInput("n + n");
+    if (!slr1.isAccepted || SLR1Parser::getProductionLeftSides().size() != 3) {
+        failures++;
+        std::cerr << "FAIL SLR1 state was changed by LL1Parser::readGrammarFromString (" << slr1.message << ")\n";
+    }
+
+    std::cout.clear();
+    std::cout << (failures == 0 ? "ll1_parser_test: all passed\n" : "ll1_parser_test: failures\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// SLR1Parser 的回归测试：不带语义动作的文法按原样切分输入记号；右部混写 ε 时按实际长度归约
+#include "core/slr1_parser.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    int failures = 0;
+
+    SLR1Parser::ParseResult parse(const std::string& grammar, const std::string& input) {
+        SLR1Parser::readGrammarFromString(grammar);
+        return SLR1Parser::parseInput(input);
+    }
+
+    void expectAccepted(const std::string& grammar, const std::string& input, bool expected) {
+        SLR1Parser::ParseResult result = parse(grammar, input);
+        if (result.isAccepted == expected) return;
+        failures++;
+        std::cerr << "FAIL \"" << input << "\": " << (expected ? "expected accept" : "expected reject")
+                  << " (" << result.message << ")\n";
+    }
+
+    void expectStep(const SLR1Parser::ParseResult& result, size_t index, const std::string& stateStack,
+                    const std::string& action) {
+        if (index < result.parseSteps.size() && result.parseSteps[index].stateStack == stateStack &&
+            result.parseSteps[index].action == action) return;
+        failures++;
+        std::cerr << "FAIL step " << index << ": expected [" << stateStack << "] " << action;
+        if (index < result.parseSteps.size()) {
+            std::cerr << ", got [" << result.parseSteps[index].stateStack << "] " << result.parseSteps[index].action;
+        }
+        std::cerr << "\n";
+    }
+}
+
+int main() {
+    // 构建过程的日志写在标准输出上
+    std::cout.setstate(std::ios::failbit);
+
+    // 没有语义动作时含 ':' 的输入记号不被拆开："a:1" 不是终结符 a
+    expectAccepted("S -> a", "a:1", false);
+    SLR1Parser::ParseResult verbatim = parse("S -> a", "a:1");
+    if (verbatim.parseSteps.empty() || verbatim.parseSteps[0].remainingInput.rfind("a:1 ", 0) != 0) {
+        failures++;
+        std::cerr << "FAIL \"a:1\" was not kept as one token\n";
+    }
+    expectAccepted("S -> a : 1", "a : 1", true);
+
+    // 右部混写 ε：只弹出非 ε 符号，栈底状态保留
+    SLR1Parser::ParseResult mixed = parse("S -> A c\nA -> x ε", "x c");
+    if (!mixed.isAccepted) {
+        failures++;
+        std::cerr << "FAIL mixed epsilon: " << mixed.message << "\n";
+    }
+    expectStep(mixed, 1, "0 3 ", "reduce A->x");
+    expectStep(mixed, 2, "0 1 ", "shift 4");
+    expectStep(mixed, 4, "0 2 ", "accept");
+
+    SLR1Parser::ParseResult single = parse("S -> at:10 ε", "at:10");
+    expectStep(single, 1, "0 2 ", "reduce S->at:10");
+    expectStep(single, 2, "0 1 ", "accept");
+
+    // $n 的上界不计 ε
+    try {
+        SLR1Parser::readGrammarFromString("S -> x ε { $2 }");
+        failures++;
+        std::cerr << "FAIL $2 accepted for a one-symbol production\n";
+    } catch (const std::runtime_error&) {
+    }
+
+    // 带语义动作时 "终结符:数值" 仍携带语义值
+    SLR1Parser::ParseResult result = parse("E -> E + n { $1 + $3 } | n { $1 }", "n:2 + n:40");
+    if (!result.isAccepted || !result.hasSemanticValue || result.semanticValue != 42) {
+        failures++;
+        std::cerr << "FAIL semantic tokens: " << result.message << " value " << result.semanticValue << "\n";
+    }
+    result = parse("S -> A { $1 }\nA -> x ε { $1 * 2 }", "x:5");
+    if (!result.isAccepted || result.semanticValue != 10) {
+        failures++;
+        std::cerr << "FAIL mixed epsilon value: " << result.message << " value " << result.semanticValue << "\n";
+    }
+
+    std::cout.clear();
+    std::cout << (failures == 0 ? "slr1_parser_test: all passed\n" : "slr1_parser_test: failures\n");
+    return failures == 0 ? 0 : 1;
+}
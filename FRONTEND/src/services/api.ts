@@ -12,6 +12,8 @@ export interface ParseStep {
   symbolStack: string
   remainingInput: string
   action: string
+  bypassedProductions?: number[]
+  valueStack?: string
 }
 
 export interface ParseTableRow {
@@ -29,6 +31,7 @@ export interface Production {
   index: number
   leftSide: string
   rightSide: string[]
+  semanticAction?: string
 }
 
 export interface LR0ParseResponse {
@@ -45,6 +48,8 @@ export interface LR0ParseResponse {
 export interface SLR1ParseRequest {
   grammar: string
   input: string
+  eliminateUnitReductions?: boolean
+  startSymbol?: string
 }
 
 export interface SLR1ParseResponse {
@@ -58,15 +63,62 @@ export interface SLR1ParseResponse {
   productionList: Production[]
   firstSets: Record<string, string[]>
   followSets: Record<string, string[]>
+  bypassedReductionCount?: number
+  startSymbols?: string[]
+  hasSemanticValue?: boolean
+  semanticValue?: number
+}
+
+export interface LL1ParseRequest {
+  grammar: string
+  input: string
+  startSymbol?: string
+}
+
+export interface LL1ParseTableRow {
+  nonterminal: string
+  actions: Record<string, string>
+}
+
+export interface LL1Conflict {
+  nonterminal: string
+  terminal: string
+  productions: number[]
+}
+
+export interface LL1ParseResponse {
+  success: boolean
+  message: string
+  isAccepted: boolean
+  isLL1: boolean
+  parseSteps: ParseStep[]
+  parseTable: {
+    headers: string[]
+    rows: LL1ParseTableRow[]
+  }
+  conflicts: LL1Conflict[]
+  productions: Record<string, string[][]>
+  productionList: Production[]
+  firstSets: Record<string, string[]>
+  followSets: Record<string, string[]>
 }
 
 export interface RegexBuildRequest {
   regex: string
+  construction?: 'thompson' | 'glushkov' | 'derivative'
 }
 
 export interface RegexMatchRequest {
   regex: string
   input: string
+  engine?: 'auto' | 'dfa' | 'pikevm' | 'bitparallel'
+  construction?: 'thompson' | 'glushkov' | 'derivative'
+  visualize?: boolean
+}
+
+export interface RegexCapture {
+  start: number
+  end: number
 }
 
 export interface RegexResponse {
@@ -78,6 +130,81 @@ export interface RegexResponse {
   nfaSvg: string
   dfaSvg: string
   minimizedDfaSvg: string
+  lazyDfa?: boolean
+  engine?: 'bitparallel' | 'dfa' | 'lazy-dfa' | 'pikevm' | 'counting'
+  captures?: RegexCapture[]
+}
+
+export interface RegexMatchBatchRequest {
+  regex: string
+  inputs: string[]
+  construction?: 'thompson' | 'glushkov' | 'derivative'
+}
+
+export interface RegexMatchBatchResponse {
+  success: boolean
+  message: string
+  inputCount: number
+  matchCount: number
+  verdicts: string // 第 i 个字符为 '1' 表示第 i 个输入匹配
+  engine?: 'bitparallel' | 'dfa' | 'lazy-dfa' | 'pikevm' | 'counting'
+  matchTimeMs?: number
+}
+
+export interface RegexExtractRequest {
+  regex: string
+  input?: string
+  inputs?: string[]
+}
+
+export interface RegexExtractGroup {
+  start: number
+  end: number
+  text?: string // 未参与匹配的组没有文本，start 与 end 为 -1
+}
+
+export interface RegexExtractResponse {
+  success: boolean
+  message: string
+  inputCount: number
+  matchCount: number
+  results: { matched: boolean; groups: RegexExtractGroup[] }[]
+  engine?: 'tagged-dfa' | 'pikevm' | 'dfa' | 'bitparallel' | 'counting'
+  taggedDfa?: string
+  extractTimeMs?: number
+}
+
+export interface RegexSearchRequest {
+  regex: string
+  input: string
+}
+
+export interface RegexSearchMatch {
+  start: number
+  end: number
+  text: string
+}
+
+export interface RegexSearchResponse {
+  success: boolean
+  message: string
+  matchCount: number
+  matches: RegexSearchMatch[]
+}
+
+export interface RegexSetRequest {
+  patterns: string[]
+  input: string
+}
+
+export interface RegexSetResponse {
+  success: boolean
+  message: string
+  patternCount?: number
+  matchedPatterns: number[]
+  matches: { index: number; pattern: string }[]
+  nfaStates?: number
+  dfaStates?: number
 }
 
 export interface HealthResponse {
@@ -136,6 +263,14 @@ class ApiService {
     })
   }
 
+  // LL1预测分析
+  async parseLL1(data: LL1ParseRequest): Promise<LL1ParseResponse> {
+    return this.request<LL1ParseResponse>('/ll1/parse', {
+      method: 'POST',
+      body: JSON.stringify(data),
+    })
+  }
+
   // 构建正则表达式自动机
   async buildRegex(data: RegexBuildRequest): Promise<RegexResponse> {
     return this.request<RegexResponse>('/regex/build', {
@@ -152,6 +287,38 @@ class ApiService {
     })
   }
 
+  // 在文本中搜索所有匹配
+  async searchRegex(data: RegexSearchRequest): Promise<RegexSearchResponse> {
+    return this.request<RegexSearchResponse>('/regex/search', {
+      method: 'POST',
+      body: JSON.stringify(data),
+    })
+  }
+
+  // 同一正则表达式批量匹配多个输入
+  async matchRegexBatch(data: RegexMatchBatchRequest): Promise<RegexMatchBatchResponse> {
+    return this.request<RegexMatchBatchResponse>('/regex/match-batch', {
+      method: 'POST',
+      body: JSON.stringify(data),
+    })
+  }
+
+  // 带标签的DFA提取捕获组
+  async extractRegex(data: RegexExtractRequest): Promise<RegexExtractResponse> {
+    return this.request<RegexExtractResponse>('/regex/extract', {
+      method: 'POST',
+      body: JSON.stringify(data),
+    })
+  }
+
+  // 用一组正则表达式同时匹配输入
+  async matchRegexSet(data: RegexSetRequest): Promise<RegexSetResponse> {
+    return this.request<RegexSetResponse>('/regex/set', {
+      method: 'POST',
+      body: JSON.stringify(data),
+    })
+  }
+
   // 上传语法文件
   async uploadGrammar(file: File): Promise<any> {
     const formData = new FormData()